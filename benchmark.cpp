@@ -0,0 +1,336 @@
+// 无界面性能基准：吸附、画布绘制、布局加载（直接重建与流式读文件）、合成拖拽与实时数据
+// 用法：CustomFormBenchmark [--counts 10,100,1000,5000] [--format json|csv] [--output 文件]
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMouseEvent>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <cmath>
+#include <algorithm>
+
+#include "customform.h"
+#include "formcanvas.h"
+#include "formrecord.h"
+#include "layoutfile.h"
+#include "layoutloader.h"
+#include "livefeed.h"
+#include "mainwindow.h"
+
+namespace {
+
+struct Result
+{
+    QString bench;
+    int forms = 0;
+    QString param;
+    int iterations = 0;
+    qint64 totalNs = 0;
+};
+
+// 规则排布再加少量抖动，接近真实布局里大量边缘对齐的情况
+QVector<QRect> makeLayout(int count, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    const int cols = std::max(1, int(std::ceil(std::sqrt(double(count)))));
+    QVector<QRect> rects;
+    rects.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int x = 20 + (i % cols) * 460 + rng.bounded(4) * 10;
+        const int y = 20 + (i / cols) * 320 + rng.bounded(4) * 10;
+        rects.append(QRect(x, y, CustomForm::MinimumWidth + rng.bounded(160),
+                           CustomForm::MinimumHeight + rng.bounded(120)));
+    }
+    return rects;
+}
+
+QJsonArray makeLayoutJson(int count)
+{
+    QJsonArray arr;
+    for (const QRect &r : makeLayout(count, 7)) {
+        FormRecord rec;
+        rec.geometry = r;
+        arr.append(formRecordToJson(rec));
+    }
+    return arr;
+}
+
+} // namespace
+
+// CustomForm / MainWindow 的友元，直接驱动内部热点路径
+class FormBenchmark
+{
+public:
+    static Result snapping(int forms)
+    {
+        FormCanvas canvas;
+        canvas.resize(8000, 8000);
+        const QVector<QRect> layout = makeLayout(forms, 1);
+        for (int i = 0; i < layout.size(); ++i)
+            canvas.snapIndex().insert(i, layout.at(i));
+
+        CustomForm form(&canvas);
+        form.setFormId(0);
+        form.m_dragMode = CustomForm::Move;
+
+        QRandomGenerator rng(2);
+        const int iterations = 20000;
+        QVector<QRect> probes;
+        probes.reserve(iterations);
+        for (int i = 0; i < iterations; ++i)
+            probes.append(QRect(rng.bounded(7000), rng.bounded(7000), 420, 280));
+
+        QVector<QLine> guides;
+        qint64 checksum = 0;
+        QElapsedTimer t;
+        t.start();
+        for (const QRect &r : std::as_const(probes))
+            checksum += form.applySnapping(r, &guides).x();
+        const qint64 ns = t.nsecsElapsed();
+        Q_UNUSED(checksum);
+        return {QStringLiteral("snapping"), forms, QString(), iterations, ns};
+    }
+
+    static Result paint(int forms, const QSize &canvasSize)
+    {
+        FormCanvas canvas;
+        canvas.resize(canvasSize);
+        const QVector<QRect> layout = makeLayout(forms, 3);
+        for (int i = 0; i < layout.size(); ++i)
+            canvas.setPlaceholder(i, layout.at(i));
+        canvas.setGuidelines({QLine(0, 300, canvasSize.width(), 300), QLine(500, 0, 500, canvasSize.height())});
+
+        QImage target(canvasSize, QImage::Format_ARGB32_Premultiplied);
+        canvas.render(&target);     // 预热网格图块
+
+        const int iterations = 20;
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < iterations; ++i)
+            canvas.render(&target);
+        return {QStringLiteral("paint"), forms,
+                QStringLiteral("%1x%2").arg(canvasSize.width()).arg(canvasSize.height()),
+                iterations, t.nsecsElapsed()};
+    }
+
+    // 只测从已解析的记录重建组件，不含读文件与分时解析
+    static Result load(int forms)
+    {
+        MainWindow w;
+        w.resize(1600, 1000);
+        w.show();
+        const QJsonArray arr = makeLayoutJson(forms);
+        w.recreateFromJson(arr);     // 预热对象池
+        QCoreApplication::processEvents();
+
+        const int iterations = 5;
+        qint64 ns = 0;
+        for (int i = 0; i < iterations; ++i) {
+            QElapsedTimer t;
+            t.start();
+            w.recreateFromJson(arr);
+            QCoreApplication::processEvents();
+            ns += t.nsecsElapsed();
+        }
+        return {QStringLiteral("load"), forms, QString(), iterations, ns};
+    }
+
+    // 与界面上“加载布局”同一条路径：LayoutLoader 分时读文件，记录分批建出，直到 finished
+    static Result loadStream(int forms, const QString &suffix)
+    {
+        QTemporaryDir dir;
+        const QString fileName = dir.filePath(QStringLiteral("layout.") + suffix);
+        LayoutDocument doc;
+        for (const QRect &r : makeLayout(forms, 7)) {
+            FormRecord rec;
+            rec.geometry = r;
+            doc.records.append(rec);
+        }
+        if (!dir.isValid() || !writeLayoutFile(fileName, doc))
+            return {QStringLiteral("load_stream"), forms, suffix + QStringLiteral(" unwritable"), 0, 0};
+
+        MainWindow w;
+        w.resize(1600, 1000);
+        w.show();
+        QEventLoop loop;
+        bool ok = true;
+        QObject::connect(w.m_loader, &LayoutLoader::finished, &loop, [&](bool done) {
+            ok = ok && done;
+            loop.quit();
+        });
+        auto runOnce = [&]() {
+            if (!w.loadLayoutFile(fileName)) {
+                ok = false;
+                return;
+            }
+            loop.exec();
+            QCoreApplication::processEvents();
+        };
+        runOnce();      // 预热对象池
+
+        const int iterations = 5;
+        qint64 ns = 0;
+        for (int i = 0; i < iterations && ok; ++i) {
+            QElapsedTimer t;
+            t.start();
+            runOnce();
+            ns += t.nsecsElapsed();
+        }
+        if (!ok)
+            return {QStringLiteral("load_stream"), forms, suffix + QStringLiteral(" failed"), 0, 0};
+        return {QStringLiteral("load_stream"), forms, suffix, iterations, ns};
+    }
+
+    static Result drag(int forms)
+    {
+        MainWindow w;
+        w.resize(1600, 1000);
+        w.show();
+        w.recreateFromJson(makeLayoutJson(forms));
+        QCoreApplication::processEvents();
+
+        CustomForm *f = w.m_widgets.value(0).data();
+        if (!f)
+            return {QStringLiteral("drag"), forms, QStringLiteral("no form"), 0, 0};
+
+        // 每次移动后停掉帧节拍，让下一次输入立即成帧，测的是单帧的端到端开销
+        const QPoint start = f->mapToGlobal(f->rect().center());
+        auto send = [f](QEvent::Type type, const QPoint &global, Qt::MouseButton button,
+                        Qt::MouseButtons buttons) {
+            QMouseEvent ev(type, f->mapFromGlobal(global), global, button, buttons, Qt::NoModifier);
+            QCoreApplication::sendEvent(f, &ev);
+        };
+
+        const int frames = 300;
+        QElapsedTimer t;
+        t.start();
+        send(QEvent::MouseButtonPress, start, Qt::LeftButton, Qt::LeftButton);
+        for (int i = 1; i <= frames; ++i) {
+            const QPoint offset(int(400 * std::sin(i / 30.0)), (i % 100) * 3);
+            send(QEvent::MouseMove, start + offset, Qt::NoButton, Qt::LeftButton);
+            f->m_frameTimer->stop();
+            QCoreApplication::processEvents();
+        }
+        send(QEvent::MouseButtonRelease, start, Qt::LeftButton, Qt::NoButton);
+        QCoreApplication::processEvents();
+        return {QStringLiteral("drag"), forms, QString(), frames, t.nsecsElapsed()};
+    }
+
+    static Result feed(int forms)
+    {
+        MainWindow w;
+        w.resize(1600, 1000);
+        w.show();
+        w.recreateFromJson(makeLayoutJson(forms));
+        QCoreApplication::processEvents();
+        for (auto it = w.m_widgets.cbegin(); it != w.m_widgets.cend(); ++it) {
+            if (CustomForm *f = it.value().data())
+                f->openDataset(LiveFeed::feedKey(it.key() % LiveFeed::kFeedCount));
+        }
+        QCoreApplication::processEvents();
+
+        // 每帧投递 2000 条（60Hz 下约 12 万条/秒），测取队列、落模型到视图重绘的整帧开销
+        const int frames = 300;
+        const int perFrame = 2000;
+        QRandomGenerator rng(4);
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < frames; ++i) {
+            for (int k = 0; k < perFrame; ++k) {
+                FeedUpdate u;
+                u.feed = int(rng.bounded(LiveFeed::kFeedCount));
+                u.row = int(rng.bounded(LiveFeed::kInitialRows));
+                u.column = 1 + int(rng.bounded(LiveFeed::kColumns - 1));
+                u.value = rng.generateDouble() * 100.0;
+                w.m_liveFeed->push(u);
+            }
+            w.m_liveFeed->drain();
+            QCoreApplication::processEvents();
+        }
+        return {QStringLiteral("feed"), forms, QStringLiteral("%1/frame").arg(perFrame), frames, t.nsecsElapsed()};
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // 默认走 offscreen 平台，可在 CI 与无显示环境运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({"counts", "逗号分隔的组件数量", "list", "10,100,1000,5000"});
+    parser.addOption({"format", "输出格式：json 或 csv", "format", "json"});
+    parser.addOption({"output", "输出文件，缺省写到标准输出", "file"});
+    parser.process(app);
+
+    QVector<int> counts;
+    for (const QString &s : parser.value("counts").split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int n = s.trimmed().toInt(&ok);
+        if (ok && n > 0)
+            counts.append(n);
+    }
+
+    QVector<Result> results;
+    const QVector<QSize> canvasSizes = {QSize(1400, 900), QSize(2800, 1800), QSize(5600, 3600)};
+    for (int n : std::as_const(counts)) {
+        results.append(FormBenchmark::snapping(n));
+        for (const QSize &size : canvasSizes)
+            results.append(FormBenchmark::paint(n, size));
+        results.append(FormBenchmark::load(n));
+        results.append(FormBenchmark::loadStream(n, QStringLiteral("json")));
+        results.append(FormBenchmark::loadStream(n, QStringLiteral("tlay")));
+        results.append(FormBenchmark::drag(n));
+        results.append(FormBenchmark::feed(n));
+    }
+
+    QFile file;
+    if (parser.isSet("output")) {
+        file.setFileName(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            QTextStream(stderr) << "cannot open " << file.fileName() << Qt::endl;
+            return 1;
+        }
+    } else {
+        file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    auto perOpUs = [](const Result &r) {
+        return r.iterations > 0 ? r.totalNs / 1000.0 / r.iterations : 0.0;
+    };
+
+    QTextStream out(&file);
+    if (parser.value("format") == QLatin1String("csv")) {
+        out << "bench,forms,param,iterations,total_ms,per_op_us\n";
+        for (const Result &r : std::as_const(results)) {
+            out << r.bench << ',' << r.forms << ',' << r.param << ',' << r.iterations << ','
+                << r.totalNs / 1e6 << ',' << perOpUs(r) << '\n';
+        }
+    } else {
+        QJsonArray arr;
+        for (const Result &r : std::as_const(results)) {
+            QJsonObject obj;
+            obj["bench"] = r.bench;
+            obj["forms"] = r.forms;
+            if (!r.param.isEmpty())
+                obj["param"] = r.param;
+            obj["iterations"] = r.iterations;
+            obj["total_ms"] = r.totalNs / 1e6;
+            obj["per_op_us"] = perOpUs(r);
+            arr.append(obj);
+        }
+        out << QJsonDocument(arr).toJson(QJsonDocument::Indented);
+    }
+    return 0;
+}
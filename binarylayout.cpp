@@ -0,0 +1,190 @@
+#include "binarylayout.h"
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+const char kMagic[4] = { 'T', 'T', 'L', 'Y' };
+
+template <typename T>
+T readLE(const uchar *p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+template <typename T>
+void appendLE(QByteArray &out, T value)
+{
+    uchar buf[sizeof(T)];
+    qToLittleEndian<T>(value, buf);
+    out.append(reinterpret_cast<const char*>(buf), int(sizeof(T)));
+}
+}
+
+bool BinaryLayout::isBinaryLayoutFile(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(".tlay"), Qt::CaseInsensitive);
+}
+
+bool BinaryLayout::write(QIODevice *device, const QVector<FormRecord> &records, const QStringList &pageNames,
+                         QString *error)
+{
+    const quint16 pageCount = quint16(std::min<qsizetype>(pageNames.size(), 0xffff));
+    QByteArray body;
+    body.reserve(HeaderSize + RecordSize * records.size() + PageEntrySize * pageCount);
+    QByteArray strings;
+
+    // 头部的字符串表位置可以预先算出，因此记录与字符串表在同一遍里生成
+    const quint64 stringsOffset = quint64(HeaderSize) + quint64(RecordSize) * quint64(records.size())
+            + quint64(PageEntrySize) * pageCount;
+
+    body.append(kMagic, 4);
+    appendLE<quint16>(body, Version);
+    appendLE<quint16>(body, 0);
+    appendLE<quint32>(body, quint32(records.size()));
+    appendLE<quint16>(body, RecordSize);
+    appendLE<quint16>(body, pageCount);
+    appendLE<quint64>(body, stringsOffset);
+    const int stringsSizePos = int(body.size());
+    appendLE<quint64>(body, 0);
+
+    for (const FormRecord &rec : records) {
+        quint32 stateOffset = 0, stateSize = 0;
+        if (!rec.state.isEmpty()) {
+            const QByteArray json = QJsonDocument(rec.state).toJson(QJsonDocument::Compact);
+            stateOffset = quint32(strings.size());
+            stateSize = quint32(json.size());
+            strings += json;
+        }
+        appendLE<qint32>(body, rec.geometry.x());
+        appendLE<qint32>(body, rec.geometry.y());
+        appendLE<qint32>(body, rec.geometry.width());
+        appendLE<qint32>(body, rec.geometry.height());
+        appendLE<quint32>(body, stateOffset);
+        appendLE<quint32>(body, stateSize);
+        appendLE<qint32>(body, rec.page);
+    }
+    for (int i = 0; i < pageCount; ++i) {
+        const QByteArray name = pageNames.at(i).toUtf8();
+        appendLE<quint32>(body, quint32(strings.size()));
+        appendLE<quint32>(body, quint32(name.size()));
+        strings += name;
+    }
+    qToLittleEndian<quint64>(quint64(strings.size()), reinterpret_cast<uchar*>(body.data() + stringsSizePos));
+
+    if (device->write(body) != body.size() || device->write(strings) != strings.size()) {
+        if (error)
+            *error = device->errorString();
+        return false;
+    }
+    return true;
+}
+
+BinaryLayout::~BinaryLayout()
+{
+    close();
+}
+
+bool BinaryLayout::open(const QString &fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < HeaderSize) {
+        m_error = QObject::tr("文件格式不正确");
+        close();
+        return false;
+    }
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    const uchar *h = m_data;
+    const quint16 version = readLE<quint16>(h + 4);
+    m_count = readLE<quint32>(h + 8);
+    m_recordSize = readLE<quint16>(h + 12);
+    const quint16 pageCount = readLE<quint16>(h + 14);
+    m_stringsOffset = readLE<quint64>(h + 16);
+    m_stringsSize = readLE<quint64>(h + 24);
+
+    // 记录长度允许比当前版本更长（新版本追加字段），读取时跳过多余部分
+    // 各区间分别比较，避免偏移与长度相加时在 quint64 中回绕；字符串表不得与记录区、页面表重叠
+    const quint64 fileSize = quint64(m_size);
+    const quint64 recordsEnd = quint64(HeaderSize) + quint64(m_count) * m_recordSize;
+    const quint64 pagesEnd = recordsEnd + quint64(PageEntrySize) * pageCount;
+    const bool valid = std::equal(kMagic, kMagic + 4, reinterpret_cast<const char*>(h))
+            && version >= 1 && version <= Version
+            && m_recordSize >= RecordSizeV1
+            && pagesEnd <= fileSize
+            && m_stringsOffset >= pagesEnd
+            && m_stringsOffset <= fileSize
+            && m_stringsSize <= fileSize - m_stringsOffset;
+    if (!valid) {
+        m_error = QObject::tr("文件格式不正确");
+        close();
+        return false;
+    }
+
+    for (int i = 0; i < pageCount; ++i) {
+        const uchar *p = m_data + recordsEnd + qint64(i) * PageEntrySize;
+        const quint32 nameOffset = readLE<quint32>(p);
+        const quint32 nameSize = readLE<quint32>(p + 4);
+        QString name;
+        if (nameSize > 0 && quint64(nameOffset) + nameSize <= m_stringsSize)
+            name = QString::fromUtf8(reinterpret_cast<const char*>(m_data + m_stringsOffset + nameOffset),
+                                     int(nameSize));
+        m_pageNames.append(name);
+    }
+    return true;
+}
+
+void BinaryLayout::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+    m_data = nullptr;
+    if (m_file.isOpen())
+        m_file.close();
+    m_size = 0;
+    m_count = 0;
+    m_pageNames.clear();
+}
+
+const uchar *BinaryLayout::recordAt(int index) const
+{
+    return m_data + HeaderSize + qint64(index) * m_recordSize;
+}
+
+QRect BinaryLayout::geometry(int index) const
+{
+    const uchar *r = recordAt(index);
+    return QRect(readLE<qint32>(r), readLE<qint32>(r + 4),
+                 std::max(readLE<qint32>(r + 8), 1), std::max(readLE<qint32>(r + 12), 1));
+}
+
+FormRecord BinaryLayout::record(int index) const
+{
+    FormRecord rec;
+    rec.geometry = geometry(index);
+
+    const uchar *r = recordAt(index);
+    if (m_recordSize >= RecordSize)
+        rec.page = std::max(0, readLE<qint32>(r + 24));
+    const quint32 stateOffset = readLE<quint32>(r + 16);
+    const quint32 stateSize = readLE<quint32>(r + 20);
+    if (stateSize > 0 && quint64(stateOffset) + stateSize <= m_stringsSize) {
+        const QByteArray json = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(m_data + m_stringsOffset + stateOffset), int(stateSize));
+        rec.state = QJsonDocument::fromJson(json).object();
+    }
+    return rec;
+}
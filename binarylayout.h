@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "formrecord.h"
+
+class QIODevice;
+
+// 二进制布局格式（小端）：
+//   Header  32 字节  magic "TTLY" | version u16 | flags u16 | count u32 | recordSize u16 | pageCount u16
+//                    | stringsOffset u64 | stringsSize u64
+//   Record  28 字节  x i32 | y i32 | w i32 | h i32 | stateOffset u32 | stateSize u32 | page i32
+//                    （版本 1 的记录为 24 字节，没有 page，读作第 0 页）；count 只计组件
+//   Page     8 字节  nameOffset u32 | nameSize u32，共 pageCount 项，紧跟记录区，按页号排列
+//                    （pageCount 原为保留字段，旧文件为 0，即没有页面名称）
+//   Strings          各组件 state 的紧凑 JSON 与页面名称（UTF-8），按偏移引用；size 为 0 表示空
+// 读取时整个文件内存映射，几何字段直接从映射区取出，不为每条记录分配内存
+class BinaryLayout
+{
+public:
+    static constexpr quint16 Version = 2;
+    static constexpr int HeaderSize = 32;
+    static constexpr int RecordSize = 28;
+    static constexpr int RecordSizeV1 = 24;
+    static constexpr int PageEntrySize = 8;
+
+    static bool isBinaryLayoutFile(const QString &fileName);
+
+    // 单遍写出：记录区顺序写入，state 同时追加到字符串表，最后写字符串表
+    static bool write(QIODevice *device, const QVector<FormRecord> &records, const QStringList &pageNames,
+                      QString *error = nullptr);
+
+    BinaryLayout() = default;
+    ~BinaryLayout();
+    BinaryLayout(const BinaryLayout &) = delete;
+    BinaryLayout &operator=(const BinaryLayout &) = delete;
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_error; }
+
+    int count() const { return int(m_count); }
+    QRect geometry(int index) const;
+    FormRecord record(int index) const;
+    // 打开时已读出，数量很少
+    QStringList pageNames() const { return m_pageNames; }
+
+private:
+    const uchar *recordAt(int index) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_count = 0;
+    quint16 m_recordSize = RecordSize;
+    quint64 m_stringsOffset = 0;
+    quint64 m_stringsSize = 0;
+    QStringList m_pageNames;
+    QString m_error;
+};
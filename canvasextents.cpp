@@ -0,0 +1,34 @@
+#include "canvasextents.h"
+
+void CanvasExtents::insert(int key, const QRect &rect)
+{
+    auto it = m_rects.find(key);
+    if (it != m_rects.end()) {
+        if (*it == rect)
+            return;
+        m_rights.erase(m_rights.find(it->right()));
+        m_bottoms.erase(m_bottoms.find(it->bottom()));
+        *it = rect;
+    } else {
+        m_rects.insert(key, rect);
+    }
+    m_rights.insert(rect.right());
+    m_bottoms.insert(rect.bottom());
+}
+
+void CanvasExtents::remove(int key)
+{
+    auto it = m_rects.find(key);
+    if (it == m_rects.end())
+        return;
+    m_rights.erase(m_rights.find(it->right()));
+    m_bottoms.erase(m_bottoms.find(it->bottom()));
+    m_rects.erase(it);
+}
+
+void CanvasExtents::clear()
+{
+    m_rects.clear();
+    m_rights.clear();
+    m_bottoms.clear();
+}
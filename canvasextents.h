@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QHash>
+#include <QRect>
+#include <set>
+
+// 组件右/下边缘的有序多重集合，增量维护画布所需的最大范围
+class CanvasExtents
+{
+public:
+    void insert(int key, const QRect &rect);   // 已存在则更新
+    void remove(int key);
+    void clear();
+
+    bool isEmpty() const { return m_rects.isEmpty(); }
+
+    // 无组件时返回 0
+    int maxRight() const  { return m_rights.empty()  ? 0 : *m_rights.rbegin(); }
+    int maxBottom() const { return m_bottoms.empty() ? 0 : *m_bottoms.rbegin(); }
+
+private:
+    QHash<int, QRect> m_rects;
+    std::multiset<int> m_rights;
+    std::multiset<int> m_bottoms;
+};
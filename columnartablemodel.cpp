@@ -0,0 +1,170 @@
+#include "columnartablemodel.h"
+
+#include <QWeakPointer>
+#include <algorithm>
+
+ColumnarTableModel::ColumnarTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    // 下标 0 固定为空串，新行的字符串单元默认指向它
+    intern(QString());
+}
+
+QSharedPointer<ColumnarTableModel> ColumnarTableModel::shared(const QString &key,
+                                                              const std::function<void(ColumnarTableModel*)> &populate)
+{
+    // 仅在 GUI 线程使用
+    static QHash<QString, QWeakPointer<ColumnarTableModel>> registry;
+
+    if (QSharedPointer<ColumnarTableModel> existing = registry.value(key).toStrongRef())
+        return existing;
+
+    QSharedPointer<ColumnarTableModel> model(new ColumnarTableModel, &QObject::deleteLater);
+    if (populate)
+        populate(model.data());
+    registry.insert(key, model.toWeakRef());
+    return model;
+}
+
+int ColumnarTableModel::addColumn(const QString &name, ColumnType type)
+{
+    Column col;
+    col.name = name;
+    col.type = type;
+    if (type == NumberColumn)
+        col.numbers.resize(m_rows);
+    else
+        col.strings.resize(m_rows);
+    m_columns.append(col);
+    return int(m_columns.size()) - 1;
+}
+
+void ColumnarTableModel::resizeRows(int rows)
+{
+    m_rows = std::max(0, rows);
+    for (Column &col : m_columns) {
+        if (col.type == NumberColumn)
+            col.numbers.resize(m_rows);
+        else
+            col.strings.resize(m_rows);
+    }
+}
+
+void ColumnarTableModel::appendRows(int count)
+{
+    if (count <= 0)
+        return;
+    beginInsertRows(QModelIndex(), m_rows, m_rows + count - 1);
+    resizeRows(m_rows + count);
+    endInsertRows();
+}
+
+void ColumnarTableModel::notifyCellsChanged(int top, int left, int bottom, int right)
+{
+    top = std::max(0, top);
+    left = std::max(0, left);
+    bottom = std::min(bottom, m_rows - 1);
+    right = std::min(right, int(m_columns.size()) - 1);
+    if (top > bottom || left > right)
+        return;
+    emit dataChanged(index(top, left), index(bottom, right), {Qt::DisplayRole, Qt::EditRole});
+}
+
+void ColumnarTableModel::setNumber(int row, int column, double value)
+{
+    Column &col = m_columns[column];
+    if (col.type == NumberColumn)
+        col.numbers[row] = value;
+    else
+        col.strings[row] = intern(QString::number(value));
+}
+
+void ColumnarTableModel::setString(int row, int column, const QString &value)
+{
+    Column &col = m_columns[column];
+    if (col.type == StringColumn)
+        col.strings[row] = intern(value);
+    else
+        col.numbers[row] = value.toDouble();
+}
+
+int ColumnarTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int ColumnarTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_columns.size());
+}
+
+QVariant ColumnarTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows || index.column() >= m_columns.size())
+        return QVariant();
+
+    const Column &col = m_columns.at(index.column());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        if (col.type == NumberColumn)
+            return col.numbers.at(index.row());
+        return m_stringPool.at(col.strings.at(index.row()));
+    case Qt::TextAlignmentRole:
+        if (col.type == NumberColumn)
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ColumnarTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Horizontal && section >= 0 && section < m_columns.size()) {
+        const QString &name = m_columns.at(section).name;
+        return name.isEmpty() ? QVariant(section + 1) : QVariant(name);
+    }
+    return section + 1;
+}
+
+Qt::ItemFlags ColumnarTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    if (m_readOnly)
+        return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+bool ColumnarTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (m_readOnly || role != Qt::EditRole || !index.isValid() || index.row() >= m_rows || index.column() >= m_columns.size())
+        return false;
+
+    Column &col = m_columns[index.column()];
+    if (col.type == NumberColumn) {
+        bool ok = false;
+        const double v = value.toDouble(&ok);
+        if (!ok)
+            return false;
+        col.numbers[index.row()] = v;
+    } else {
+        col.strings[index.row()] = intern(value.toString());
+    }
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    return true;
+}
+
+int ColumnarTableModel::intern(const QString &value)
+{
+    const auto it = m_stringIds.constFind(value);
+    if (it != m_stringIds.constEnd())
+        return it.value();
+    const int id = int(m_stringPool.size());
+    m_stringPool.append(value);
+    m_stringIds.insert(value, id);
+    return id;
+}
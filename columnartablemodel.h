@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+// 按列连续存储的只读/可编辑表格模型：数值列不装箱，字符串列存驻留池下标
+// 同一数据集可被多个 CustomForm 共享，见 shared()
+class ColumnarTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum ColumnType { NumberColumn, StringColumn };
+
+    explicit ColumnarTableModel(QObject *parent = nullptr);
+
+    // 按 key 取共享实例；不存在时新建并调用 populate 填充。最后一个持有者释放后实例销毁
+    static QSharedPointer<ColumnarTableModel> shared(const QString &key,
+                                                     const std::function<void(ColumnarTableModel*)> &populate);
+
+    // 批量构建接口：不发模型信号，只在挂到视图之前使用
+    int addColumn(const QString &name, ColumnType type);
+    void resizeRows(int rows);
+    void setNumber(int row, int column, double value);
+    void setString(int row, int column, const QString &value);
+
+    // 实时更新接口：一批追加的行只发一次 rowsInserted；单元格用上面的 set* 静默写入，
+    // 再由调用方把一帧内改过的范围合并成一次 dataChanged
+    void appendRows(int count);
+    void notifyCellsChanged(int top, int left, int bottom, int right);
+
+    // 只读时视图不能编辑单元格；实时更新接口不受影响
+    void setReadOnly(bool readOnly) { m_readOnly = readOnly; }
+    bool isReadOnly() const { return m_readOnly; }
+
+    ColumnType columnType(int column) const { return m_columns.at(column).type; }
+    int stringPoolSize() const { return int(m_stringPool.size()); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+private:
+    struct Column {
+        QString name;
+        ColumnType type = StringColumn;
+        QVector<double> numbers;    // NumberColumn
+        QVector<int> strings;       // StringColumn：m_stringPool 下标
+    };
+
+    int intern(const QString &value);
+
+    QVector<Column> m_columns;
+    int m_rows = 0;
+    bool m_readOnly = false;
+    QVector<QString> m_stringPool;
+    QHash<QString, int> m_stringIds;
+};
@@ -1,5 +1,9 @@
 #include "customform.h"
 #include "formcanvas.h"
+#include "columnartablemodel.h"
+#include "mappedcsvmodel.h"
+#include "frameprofiler.h"
+#include "livefeed.h"
 
 #include <QApplication>
 #include <QMouseEvent>
@@ -9,12 +13,14 @@
 #include <QTabWidget>
 #include <QTableView>
 #include <QHeaderView>
-#include <QStandardItemModel>
-#include <QEnterEvent>
-#include <QCursor>
 #include <QMenu>
 #include <QContextMenuEvent>
 #include <QTextEdit>
+#include <QTextDocument>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QTimer>
+#include <QScreen>
 #include <QVector>
 #include <QLine>
 #include <cmath>
@@ -28,6 +34,7 @@ CustomForm::CustomForm(QWidget *parent)
     // 注意：作为子部件时仍然允许 Frameless 外观，这样我们自绘边框并处理拖拽/缩放
     setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
     setMinimumSize(m_minw, m_minh);
+    m_log = QSharedPointer<LogBuffer>::create();
 
     auto *vl = new QVBoxLayout(this);
     vl->setContentsMargins(1,1,1,1);
@@ -36,33 +43,201 @@ CustomForm::CustomForm(QWidget *parent)
     m_tabs = new QTabWidget(this);
     vl->addWidget(m_tabs);
 
-    // Tab1：表格
-    QWidget *page1 = new QWidget;
-    auto *pageLay = new QVBoxLayout(page1);
-    pageLay->setContentsMargins(6,6,6,6);
-    m_table = new QTableView(page1);
-    auto *model = new QStandardItemModel(15, 5, m_table);
-    for (int r=0; r<model->rowCount(); ++r)
-        for (int c=0; c<model->columnCount(); ++c)
-            model->setData(model->index(r,c), QString("R%1C%2").arg(r).arg(c));
-    m_table->setModel(model);
+    // 页签按需构建：先放空白页，首次成为当前页时才调用构建函数
+    addLazyTab("表格", [this](QVBoxLayout *lay) { buildTablePage(lay); });
+    addLazyTab("文本", [this](QVBoxLayout *lay) { buildTextPage(lay); });
+    addLazyTab("日志", [this](QVBoxLayout *lay) { buildLogPage(lay); });
+    connect(m_tabs, &QTabWidget::currentChanged, this, &CustomForm::ensurePageBuilt);
+    connect(m_tabs, &QTabWidget::currentChanged, this, &CustomForm::contentChanged);
+
+    // 拖拽帧节拍：单次定时器，按屏幕刷新率节流
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &CustomForm::processDragFrame);
+
+    // 悬停光标由 FormCanvas 统一分发，这里不再给子部件开鼠标跟踪或装过滤器
+
+    ensurePageBuilt(m_tabs->currentIndex());
+}
+
+void CustomForm::addLazyTab(const QString &title, PageFactory factory)
+{
+    auto *page = new QWidget;
+    auto *lay = new QVBoxLayout(page);
+    lay->setContentsMargins(6,6,6,6);
+    m_pages.append({page, std::move(factory)});
+    m_tabs->addTab(page, title);
+}
+
+void CustomForm::ensurePageBuilt(int index)
+{
+    if (index < 0 || index >= m_pages.size())
+        return;
+    LazyPage &lp = m_pages[index];
+    if (!lp.factory)
+        return;
+    const PageFactory factory = std::move(lp.factory);
+    lp.factory = nullptr;
+    factory(static_cast<QVBoxLayout*>(lp.page->layout()));
+}
+
+void CustomForm::buildTablePage(QVBoxLayout *lay)
+{
+    m_table = new QTableView;
     m_table->horizontalHeader()->setStretchLastSection(true);
-    pageLay->addWidget(m_table);
-    m_tabs->addTab(page1, "表格");
-
-    // Tab2：文本
-    QWidget *page2 = new QWidget;
-    auto *pageLay2 = new QVBoxLayout(page2);
-    pageLay2->setContentsMargins(6,6,6,6);
-    auto *te = new QTextEdit(page2);
-    te->setPlainText("可拖动/可缩放的自定义组件。\n右键关闭。");
-    pageLay2->addWidget(te);
-    m_tabs->addTab(page2, "文本");
-
-    // 鼠标跟踪与事件过滤
-    setMouseTracking(true);
-    setMouseTrackingRecursive(this, true);
-    installCursorEventFilterRecursive(this);
+    lay->addWidget(m_table);
+    applyTableModel();
+}
+
+bool CustomForm::openDataset(const QString &path)
+{
+    if (path == m_datasetPath)
+        return true;
+    const QString previous = m_datasetPath;
+    m_datasetPath = path;
+    if (applyTableModel())
+        return true;
+    m_datasetPath = previous;
+    applyTableModel();
+    return false;
+}
+
+bool CustomForm::applyTableModel()
+{
+    // 表格页尚未构建时只记下路径，构建时再打开
+    if (!m_table)
+        return true;
+
+    QSharedPointer<QAbstractItemModel> model;
+    bool ok = true;
+    if (m_datasetPath.isEmpty()) {
+        // 所有组件共享同一份示例数据集；它是只读的，否则一个组件里的编辑会出现在所有组件中
+        model = ColumnarTableModel::shared(QStringLiteral("demo"), &CustomForm::populateDemoDataset);
+    } else if (LiveFeed::isFeedKey(m_datasetPath)) {
+        // 实时数据源的模型由 LiveFeed 持有并更新，这里只是共享它
+        model = ColumnarTableModel::shared(m_datasetPath, &LiveFeed::populate);
+    } else {
+        QSharedPointer<MappedCsvModel> csv = MappedCsvModel::shared(m_datasetPath);
+        ok = csv->errorString().isEmpty();
+        if (ok)
+            model = csv;
+    }
+    if (!ok)
+        return false;
+
+    if (m_model != model) {
+        if (m_model)
+            m_model->disconnect(this);
+        QAbstractItemModel *m = model.data();
+        connect(m, &QAbstractItemModel::dataChanged, this, &CustomForm::contentChanged);
+        connect(m, &QAbstractItemModel::rowsInserted, this, &CustomForm::contentChanged);
+        connect(m, &QAbstractItemModel::rowsRemoved, this, &CustomForm::contentChanged);
+        connect(m, &QAbstractItemModel::modelReset, this, &CustomForm::contentChanged);
+        connect(m, &QAbstractItemModel::layoutChanged, this, &CustomForm::contentChanged);
+    }
+    m_table->setModel(model.data());
+    m_model = model;
+    emit contentChanged();
+    return true;
+}
+
+void CustomForm::buildTextPage(QVBoxLayout *lay)
+{
+    m_textEdit = new QTextEdit;
+    m_textEdit->setPlainText(defaultText());
+    m_textEdit->document()->setModified(false);
+    connect(m_textEdit->document(), &QTextDocument::contentsChanged, this, &CustomForm::contentChanged);
+    lay->addWidget(m_textEdit);
+}
+
+void CustomForm::buildLogPage(QVBoxLayout *lay)
+{
+    // 页签构建前追加的行已在缓冲里，构建后直接显示
+    m_logView = new LogView(m_log.data());
+    lay->addWidget(m_logView);
+    // 页签容器就是布局所在的部件，不依赖页签顺序
+    QWidget *page = lay->parentWidget();
+    connect(m_logView, &LogView::refreshed, this, [this, page]() {
+        if (m_tabs->currentWidget() == page)
+            emit contentChanged();
+    });
+}
+
+void CustomForm::appendLog(const QString &line)
+{
+    m_log->append(line);
+    if (m_logView)
+        m_logView->scheduleRefresh();
+}
+
+void CustomForm::setLogBuffer(const QSharedPointer<LogBuffer> &buffer)
+{
+    if (!buffer || buffer == m_log)
+        return;
+    m_log = buffer;
+    if (m_logView)
+        m_logView->setBuffer(m_log.data());
+}
+
+void CustomForm::populateDemoDataset(ColumnarTableModel *model)
+{
+    const int rows = 15, cols = 5;
+    for (int c=0; c<cols; ++c)
+        model->addColumn(QString(), ColumnarTableModel::StringColumn);
+    model->resizeRows(rows);
+    for (int r=0; r<rows; ++r)
+        for (int c=0; c<cols; ++c)
+            model->setString(r, c, QString("R%1C%2").arg(r).arg(c));
+    model->setReadOnly(true);
+}
+
+QString CustomForm::defaultText()
+{
+    return QStringLiteral("可拖动/可缩放的自定义组件。\n右键关闭。");
+}
+
+void CustomForm::resetForReuse()
+{
+    // 回收进对象池前恢复为刚构造时的状态；文本只在被编辑过时才重建，示例表格数据集共享且只读，无需恢复
+    m_frameTimer->stop();
+    m_pendingInputEvents = 0;
+    m_lastFrameCoalescedEvents = 0;
+    m_dragMode = None;
+    m_groupDrag = false;
+    if (m_snapshotDrag) {
+        m_snapshotDrag = false;
+        if (FormCanvas *c = canvas())
+            c->hideDragPreview();
+    }
+    m_formId = -1;
+
+    m_tabs->setCurrentIndex(0);
+    openDataset(QString());
+    if (m_textEdit && m_textEdit->document()->isModified()) {
+        m_textEdit->setPlainText(defaultText());
+        m_textEdit->document()->setModified(false);
+    }
+    // 日志缓冲归 MainWindow 按 id 保管，这里只换回一个空缓冲，不清空原来的
+    setLogBuffer(QSharedPointer<LogBuffer>::create());
+    unsetCursor();
+}
+
+QJsonObject CustomForm::saveState() const
+{
+    QJsonObject state;
+    state["tab"] = m_tabs->currentIndex();
+    if (!m_datasetPath.isEmpty())
+        state["dataset"] = m_datasetPath;
+    return state;
+}
+
+void CustomForm::restoreState(const QJsonObject &state)
+{
+    const int tab = state.value("tab").toInt(0);
+    if (tab >= 0 && tab < m_tabs->count())
+        m_tabs->setCurrentIndex(tab);
+    openDataset(state.value("dataset").toString());
 }
 
 void CustomForm::paintEvent(QPaintEvent *ev)
@@ -77,43 +252,77 @@ void CustomForm::paintEvent(QPaintEvent *ev)
     pen.setWidth(1);
     p.setPen(pen);
     p.drawRect(rect().adjusted(0,0,-1,-1));
-}
+    p.end();
 
-void CustomForm::enterEvent(QEnterEvent *e)
-{
-    QWidget::enterEvent(e);
-    clearAncestorCursors();
-    updateCursorByPos(mapFromGlobal(QCursor::pos()));
-}
-
-void CustomForm::leaveEvent(QEvent *e)
-{
-    QWidget::leaveEvent(e);
-    unsetCursor();
-    updateGuidelines({});
+    if (FrameProfiler::isEnabled())
+        FrameProfiler::instance().markPresented();
 }
 
 void CustomForm::mousePressEvent(QMouseEvent *ev)
 {
     if (ev->button() != Qt::LeftButton) return;
-    m_dragMode = hitTest(ev->pos());
+    FormCanvas *c = canvas();
+
+    // Ctrl/Shift 点选只切换选中状态，不开始拖拽
+    if (c && (ev->modifiers() & (Qt::ControlModifier | Qt::ShiftModifier))) {
+        c->toggleSelected(m_formId);
+        m_dragMode = None;
+        ev->accept();
+        return;
+    }
+    if (c && !c->isSelected(m_formId))
+        c->setSelection({m_formId});
+
+    m_dragMode = hitTest(size(), ev->pos());
     m_pressGlobalPos = ev->globalPosition().toPoint();
     m_pressGeometry = geometry();
+
+    // 选中多个时从内部拖动即整组移动：以组的外接矩形做一次吸附，由父窗口批量落地
+    m_groupDrag = c && m_dragMode == Move && c->selection().size() > 1;
+    if (m_groupDrag) {
+        m_pressGroupBounds = c->selectionBounds();
+        emit groupDragStarted();
+    } else if (m_dragMode != None) {
+        emit dragStarted();
+    }
+
+    // 快照模式：按下时抓取一次外观，拖拽过程中不再触碰真实组件的几何与布局
+    m_snapshotDrag = false;
+    if (m_dragRenderMode == SnapshotDrag && m_dragMode != None && !m_groupDrag) {
+        if (FormCanvas *c = canvas()) {
+            m_snapshotDrag = true;
+            m_previewGeometry = m_pressGeometry;
+            c->showDragPreview(grab(), m_pressGeometry);
+        }
+    }
     ev->accept();
 }
 
 void CustomForm::mouseMoveEvent(QMouseEvent *ev)
 {
-    const QPoint global = ev->globalPosition().toPoint();
-    const QPoint delta  = global - m_pressGlobalPos;
+    if (m_dragMode == None)
+        return;
 
-    if (m_dragMode == None) {
-        updateCursorByPos(ev->pos());
-        updateGuidelines({});
+    // 只记录最新位置；每帧最多处理一次，同一帧内的其余输入被合并
+    if (FrameProfiler::isEnabled())
+        FrameProfiler::instance().markInput();
+    m_pendingGlobalPos = ev->globalPosition().toPoint();
+    ++m_pendingInputEvents;
+    if (!m_frameTimer->isActive())
+        processDragFrame();
+}
+
+void CustomForm::processDragFrame()
+{
+    if (m_dragMode == None || m_pendingInputEvents == 0)
         return;
-    }
+    ProfileScope frameScope(FrameProfiler::DragFrame);
+
+    const QPoint delta = m_pendingGlobalPos - m_pressGlobalPos;
+    m_lastFrameCoalescedEvents = m_pendingInputEvents;
+    m_pendingInputEvents = 0;
 
-    QRect g = m_pressGeometry;
+    QRect g = m_groupDrag ? m_pressGroupBounds : m_pressGeometry;
     switch (m_dragMode) {
     case Move: {
         QPoint p = g.topLeft() + delta;
@@ -144,56 +353,106 @@ void CustomForm::mouseMoveEvent(QMouseEvent *ev)
     if (g.height() < m_minh) g.setHeight(m_minh);
 
     QVector<QLine> guides;
-    QRect snapped = applySnapping(g, &guides);
-    setGeometry(snapped);
-    updateGuidelines(guides);
+    QRect snapped;
+    {
+        ProfileScope scope(FrameProfiler::Snapping);
+        snapped = applySnapping(g, &guides);
+    }
+    if (m_groupDrag) {
+        updateGuidelines(guides);
+        emit groupDragMoved(snapped.topLeft() - m_pressGroupBounds.topLeft());
+    } else if (m_snapshotDrag) {
+        m_previewGeometry = snapped;
+        if (FormCanvas *c = canvas())
+            c->moveDragPreview(snapped);
+        updateGuidelines(guides);
+        emit previewMoved(snapped);
+    } else {
+        commitGeometry(snapped);
+        updateGuidelines(guides);
+
+        // 通知父窗口更新滚动区域/容器大小（每帧一次）
+        emit moved(geometry());
+    }
+
+    if (FrameProfiler::isEnabled())
+        FrameProfiler::instance().addCoalescedInput(m_lastFrameCoalescedEvents);
+    m_frameTimer->start(frameInterval());
+}
 
-    // 通知父窗口更新滚动区域/容器大小
-    emit moved(geometry());
+void CustomForm::commitGeometry(const QRect &geom)
+{
+    // setGeometry 触发的 resizeEvent 不再单独发 moved，由调用方统一通知
+    ProfileScope scope(FrameProfiler::GeometryCommit);
+    m_committingGeometry = true;
+    setGeometry(geom);
+    m_committingGeometry = false;
+}
+
+int CustomForm::frameInterval() const
+{
+    const QScreen *s = screen();
+    const qreal hz = s ? s->refreshRate() : 60.0;
+    return hz > 0 ? std::max(1, qRound(1000.0 / hz)) : 16;
 }
 
 void CustomForm::mouseReleaseEvent(QMouseEvent *ev)
 {
     if (ev->button() != Qt::LeftButton) return;
+    // 先把本帧尚未处理的输入落地
+    processDragFrame();
+    m_frameTimer->stop();
+
+    const bool dragging = m_dragMode != None;
     m_dragMode = None;
-    unsetCursor();
+    if (m_groupDrag) {
+        m_groupDrag = false;
+        updateGuidelines({});
+        emit groupDragFinished();
+        return;
+    }
+    // 实时拖拽时最后一帧已在上面发过 moved，只有快照提交改变了几何才需要再通知
+    if (m_snapshotDrag) {
+        m_snapshotDrag = false;
+        if (FormCanvas *c = canvas())
+            c->hideDragPreview();
+        commitGeometry(m_previewGeometry);
+        emit moved(geometry());
+    }
+    // 光标由画布在收到松开事件后重新判定
     updateGuidelines({});
-    emit moved(geometry());
+    if (dragging && geometry() != m_pressGeometry)
+        emit geometryCommitted(m_pressGeometry, geometry());
+    if (dragging)
+        emit dragFinished();
 }
 
 void CustomForm::resizeEvent(QResizeEvent *e)
 {
     QWidget::resizeEvent(e);
-    updateCursorByPos(mapFromGlobal(QCursor::pos()));
-    emit moved(geometry());
-}
-
-bool CustomForm::eventFilter(QObject *obj, QEvent *event)
-{
-    switch (event->type()) {
-    case QEvent::MouseMove:
-    case QEvent::HoverMove:
-    case QEvent::Enter:
-    case QEvent::Leave: {
-        const QPoint localPos = mapFromGlobal(QCursor::pos());
-        if (!rect().contains(localPos)) {
-            unsetCursor();
-            return QWidget::eventFilter(obj, event);
-        }
-        if (m_dragMode == None) {
-            updateCursorByPos(localPos);
-        }
-        break;
-    }
-    default:
-        break;
-    }
-    return QWidget::eventFilter(obj, event);
+    if (!m_committingGeometry)
+        emit moved(geometry());
 }
 
 void CustomForm::contextMenuEvent(QContextMenuEvent *event)
 {
     QMenu menu(this);
+    QAction *openAct = menu.addAction("打开数据文件…");
+    connect(openAct, &QAction::triggered, this, [this]() {
+        const QString fileName = QFileDialog::getOpenFileName(this, tr("打开数据文件"), QString(),
+                                                              tr("数据文件 (*.csv *.tsv *.txt *.log)"));
+        if (fileName.isEmpty())
+            return;
+        if (!openDataset(fileName))
+            QMessageBox::warning(this, tr("打开失败"), tr("无法读取文件：%1").arg(fileName));
+        else
+            m_tabs->setCurrentIndex(0);
+    });
+    QAction *feedAct = menu.addAction("订阅实时数据");
+    connect(feedAct, &QAction::triggered, this, [this]() {
+        openDataset(LiveFeed::feedKey(std::max(0, m_formId) % LiveFeed::kFeedCount));
+        m_tabs->setCurrentIndex(0);
+    });
     QAction *closeAct = menu.addAction("关闭组件");
     connect(closeAct, &QAction::triggered, this, [this](){ emit requestClose(this); });
     menu.exec(event->globalPos());
@@ -213,58 +472,45 @@ QRect CustomForm::applySnapping(const QRect &rect, QVector<QLine> *guides) const
 
     const QRect parentRect = parent->rect();
     int gridSize = 20;
-    if (auto *canvas = qobject_cast<FormCanvas*>(parent))
+    const SnapIndex *index = nullptr;
+    if (auto *canvas = qobject_cast<FormCanvas*>(parent)) {
         gridSize = canvas->gridSize();
+        index = &canvas->snapIndex();
+    }
     if (gridSize <= 0)
         gridSize = 20;
 
-    auto addUnique = [](QVector<int> &vec, int value) {
-        if (!vec.contains(value))
-            vec.append(value);
-    };
-
-    QVector<int> verticalLines;
-    QVector<int> horizontalLines;
+    using SnapData = SnapIndex::Match;
 
-    addUnique(verticalLines, parentRect.left());
-    addUnique(verticalLines, parentRect.right());
-    addUnique(horizontalLines, parentRect.top());
-    addUnique(horizontalLines, parentRect.bottom());
-
-    if (gridSize > 0) {
-        for (int x = parentRect.left(); x <= parentRect.right(); x += gridSize)
-            addUnique(verticalLines, x);
-        for (int y = parentRect.top(); y <= parentRect.bottom(); y += gridSize)
-            addUnique(horizontalLines, y);
-    }
-
-    const auto siblings = parent->findChildren<CustomForm*>(QString(), Qt::FindDirectChildrenOnly);
-    for (CustomForm *other : siblings) {
-        if (other == this)
-            continue;
-        const QRect og = other->geometry();
-        addUnique(verticalLines, og.left());
-        addUnique(verticalLines, og.right());
-        addUnique(horizontalLines, og.top());
-        addUnique(horizontalLines, og.bottom());
-    }
+    // 候选：父容器边缘、网格线（算术求最近）、兄弟组件边缘（索引二分查找）
+    auto edgeMatch = [this](int value, int edge) {
+        SnapData data;
+        const int diff = std::abs(edge - value);
+        if (diff <= m_snapThreshold) {
+            data.matched = true;
+            data.target = edge;
+            data.diff = diff;
+        }
+        return data;
+    };
 
-    struct SnapData {
-        bool matched = false;
-        int target = 0;
-        int diff = 0;
+    auto evaluateX = [&](int value) {
+        SnapData data = edgeMatch(value, parentRect.left());
+        data = SnapIndex::better(data, edgeMatch(value, parentRect.right()));
+        data = SnapIndex::better(data, SnapIndex::nearestGrid(value, parentRect.left(), parentRect.right(),
+                                                               gridSize, m_snapThreshold));
+        if (index)
+            data = SnapIndex::better(data, index->nearestVertical(value, m_snapThreshold, m_formId));
+        return data;
     };
 
-    auto evaluate = [&](int value, const QVector<int> &candidates) {
-        SnapData data;
-        for (int candidate : candidates) {
-            int diff = std::abs(candidate - value);
-            if (diff <= m_snapThreshold && (!data.matched || diff < data.diff)) {
-                data.matched = true;
-                data.target = candidate;
-                data.diff = diff;
-            }
-        }
+    auto evaluateY = [&](int value) {
+        SnapData data = edgeMatch(value, parentRect.top());
+        data = SnapIndex::better(data, edgeMatch(value, parentRect.bottom()));
+        data = SnapIndex::better(data, SnapIndex::nearestGrid(value, parentRect.top(), parentRect.bottom(),
+                                                               gridSize, m_snapThreshold));
+        if (index)
+            data = SnapIndex::better(data, index->nearestHorizontal(value, m_snapThreshold, m_formId));
         return data;
     };
 
@@ -278,8 +524,8 @@ QRect CustomForm::applySnapping(const QRect &rect, QVector<QLine> *guides) const
                               m_dragMode == ResizeBottomLeft || m_dragMode == ResizeBottomRight;
 
     if (m_dragMode == Move) {
-        SnapData leftSnap = evaluate(result.left(), verticalLines);
-        SnapData rightSnap = evaluate(result.right(), verticalLines);
+        SnapData leftSnap = evaluateX(result.left());
+        SnapData rightSnap = evaluateX(result.right());
         if (leftSnap.matched || rightSnap.matched) {
             int shiftX = 0;
             if (leftSnap.matched && (!rightSnap.matched || leftSnap.diff <= rightSnap.diff)) {
@@ -292,8 +538,8 @@ QRect CustomForm::applySnapping(const QRect &rect, QVector<QLine> *guides) const
             result.translate(shiftX, 0);
         }
 
-        SnapData topSnap = evaluate(result.top(), horizontalLines);
-        SnapData bottomSnap = evaluate(result.bottom(), horizontalLines);
+        SnapData topSnap = evaluateY(result.top());
+        SnapData bottomSnap = evaluateY(result.bottom());
         if (topSnap.matched || bottomSnap.matched) {
             int shiftY = 0;
             if (topSnap.matched && (!bottomSnap.matched || topSnap.diff <= bottomSnap.diff)) {
@@ -307,28 +553,28 @@ QRect CustomForm::applySnapping(const QRect &rect, QVector<QLine> *guides) const
         }
     } else {
         if (adjustLeft) {
-            SnapData leftSnap = evaluate(result.left(), verticalLines);
+            SnapData leftSnap = evaluateX(result.left());
             if (leftSnap.matched) {
                 result.setLeft(leftSnap.target);
                 lines.append(QLine(leftSnap.target, parentRect.top(), leftSnap.target, parentRect.bottom()));
             }
         }
         if (adjustRight) {
-            SnapData rightSnap = evaluate(result.right(), verticalLines);
+            SnapData rightSnap = evaluateX(result.right());
             if (rightSnap.matched) {
                 result.setRight(rightSnap.target);
                 lines.append(QLine(rightSnap.target, parentRect.top(), rightSnap.target, parentRect.bottom()));
             }
         }
         if (adjustTop) {
-            SnapData topSnap = evaluate(result.top(), horizontalLines);
+            SnapData topSnap = evaluateY(result.top());
             if (topSnap.matched) {
                 result.setTop(topSnap.target);
                 lines.append(QLine(parentRect.left(), topSnap.target, parentRect.right(), topSnap.target));
             }
         }
         if (adjustBottom) {
-            SnapData bottomSnap = evaluate(result.bottom(), horizontalLines);
+            SnapData bottomSnap = evaluateY(result.bottom());
             if (bottomSnap.matched) {
                 result.setBottom(bottomSnap.target);
                 lines.append(QLine(parentRect.left(), bottomSnap.target, parentRect.right(), bottomSnap.target));
@@ -352,20 +598,26 @@ QRect CustomForm::applySnapping(const QRect &rect, QVector<QLine> *guides) const
 
 void CustomForm::updateGuidelines(const QVector<QLine> &guides)
 {
-    if (auto *canvas = qobject_cast<FormCanvas*>(parentWidget())) {
+    ProfileScope scope(FrameProfiler::Guidelines);
+    if (auto *c = canvas()) {
         if (guides.isEmpty())
-            canvas->clearGuidelines();
+            c->clearGuidelines();
         else
-            canvas->setGuidelines(guides);
+            c->setGuidelines(guides);
     }
 }
 
-CustomForm::DragMode CustomForm::hitTest(const QPoint &p) const
+FormCanvas* CustomForm::canvas() const
+{
+    return qobject_cast<FormCanvas*>(parentWidget());
+}
+
+CustomForm::DragMode CustomForm::hitTest(const QSize &size, const QPoint &p)
 {
-    const bool left   = p.x() < m_margin;
-    const bool right  = p.x() > width() - m_margin;
-    const bool top    = p.y() < m_margin;
-    const bool bottom = p.y() > height() - m_margin;
+    const bool left   = p.x() < ResizeMargin;
+    const bool right  = p.x() > size.width() - ResizeMargin;
+    const bool top    = p.y() < ResizeMargin;
+    const bool bottom = p.y() > size.height() - ResizeMargin;
 
     if (left && top)     return ResizeTopLeft;
     if (right && top)    return ResizeTopRight;
@@ -379,48 +631,22 @@ CustomForm::DragMode CustomForm::hitTest(const QPoint &p) const
     return Move;
 }
 
-void CustomForm::updateCursorByPos(const QPoint &pos)
+Qt::CursorShape CustomForm::cursorShapeAt(const QSize &size, const QPoint &localPos)
 {
-    switch (hitTest(pos)) {
+    switch (hitTest(size, localPos)) {
     case ResizeTopLeft:
     case ResizeBottomRight:
-        setCursor(Qt::SizeFDiagCursor); break;
+        return Qt::SizeFDiagCursor;
     case ResizeTopRight:
     case ResizeBottomLeft:
-        setCursor(Qt::SizeBDiagCursor); break;
+        return Qt::SizeBDiagCursor;
     case ResizeLeft:
     case ResizeRight:
-        setCursor(Qt::SizeHorCursor); break;
+        return Qt::SizeHorCursor;
     case ResizeTop:
     case ResizeBottom:
-        setCursor(Qt::SizeVerCursor); break;
+        return Qt::SizeVerCursor;
     default:
-        unsetCursor();
-        break;
-    }
-}
-
-void CustomForm::clearAncestorCursors()
-{
-    QWidget *p = parentWidget();
-    while (p) {
-        p->unsetCursor();
-        p = p->parentWidget();
+        return Qt::ArrowCursor;
     }
 }
-
-void CustomForm::setMouseTrackingRecursive(QWidget *w, bool on)
-{
-    if (!w) return;
-    w->setMouseTracking(on);
-    const auto children = w->findChildren<QWidget*>();
-    for (QWidget *c : children) c->setMouseTracking(on);
-}
-
-void CustomForm::installCursorEventFilterRecursive(QWidget *w)
-{
-    if (!w) return;
-    this->installEventFilter(this);
-    const auto children = w->findChildren<QWidget*>();
-    for (QWidget *c : children) c->installEventFilter(this);
-}
@@ -4,30 +4,89 @@
 #include <QRect>
 #include <QVector>
 #include <QLine>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <functional>
+
+#include "logview.h"
 
 class QTabWidget;
+class QTimer;
+class FormCanvas;
 class QTableView;
+class ColumnarTableModel;
+class QAbstractItemModel;
+class QTextEdit;
+class QVBoxLayout;
+
+class FormBenchmark;
 
 class CustomForm : public QWidget
 {
     Q_OBJECT
+    friend class FormBenchmark;     // 基准程序直接驱动内部热点路径
 public:
+    // Live：拖拽时直接改真实几何；Snapshot：拖拽时只移动快照预览，松开时一次性提交
+    enum DragRenderMode { LiveDrag, SnapshotDrag };
+
+    static constexpr int MinimumWidth  = 260;
+    static constexpr int MinimumHeight = 160;
+    static constexpr int ResizeMargin  = 8;
+
     explicit CustomForm(QWidget *parent = nullptr);
     ~CustomForm() override = default;
 
+    // 随布局保存的界面状态（当前页签等），不含几何
+    QJsonObject saveState() const;
+    void restoreState(const QJsonObject &state);
+
+    // 表格页改为显示本地 CSV/TSV 文件（内存映射，后台建立索引）；空路径恢复示例数据
+    bool openDataset(const QString &path);
+    QString datasetPath() const { return m_datasetPath; }
+
+    // 追加一行到日志页；只写环形缓冲，日志页已构建时每帧刷新一次。仅在 GUI 线程调用
+    void appendLog(const QString &line);
+    // 换用外部持有的日志缓冲（按组件 id 保存在组件之外，组件回收后日志仍在）
+    void setLogBuffer(const QSharedPointer<LogBuffer> &buffer);
+
+    // 对象池复用前调用：清除拖拽状态、id 与被编辑过的内容
+    void resetForReuse();
+
+    DragRenderMode dragRenderMode() const { return m_dragRenderMode; }
+    void setDragRenderMode(DragRenderMode mode) { m_dragRenderMode = mode; }
+
+    // 最近一帧合并掉的鼠标输入数
+    int lastFrameCoalescedEvents() const { return m_lastFrameCoalescedEvents; }
+
+    // 组件自身坐标下该点应显示的光标：缩放边缘返回对应箭头，内部返回 Qt::ArrowCursor
+    static Qt::CursorShape cursorShapeAt(const QSize &size, const QPoint &localPos);
+
+    int formId() const { return m_formId; }
+    void setFormId(int id) { m_formId = id; }
+
 signals:
     void moved(const QRect &geom);
+    // 快照拖拽时预览每帧的几何；真实几何要到松开时才提交，不发 moved
+    void previewMoved(const QRect &geom);
+    // 一次拖拽/缩放手势在松开时的最终结果
+    void geometryCommitted(const QRect &from, const QRect &to);
     void requestClose(CustomForm *self);
+    // 单个组件的拖拽/缩放手势开始与结束（结束在 geometryCommitted 之后）
+    void dragStarted();
+    void dragFinished();
+    // 整组拖拽：开始、每帧的累计位移（已吸附）、松开
+    void groupDragStarted();
+    void groupDragMoved(const QPoint &delta);
+    void groupDragFinished();
+    // 显示内容变了（切页、数据集或其数据、文本），缩略图据此失效
+    void contentChanged();
 
 protected:
     void mousePressEvent(QMouseEvent*) override;
     void mouseMoveEvent(QMouseEvent*) override;
     void mouseReleaseEvent(QMouseEvent*) override;
-    void enterEvent(QEnterEvent*) override;
-    void leaveEvent(QEvent*) override;
     void resizeEvent(QResizeEvent*) override;
     void paintEvent(QPaintEvent*) override;
-    bool eventFilter(QObject *obj, QEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
 
 private:
@@ -37,24 +96,57 @@ private:
         ResizeTopLeft, ResizeTopRight, ResizeBottomLeft, ResizeBottomRight
     };
 
-    DragMode hitTest(const QPoint &localPos) const;
-    void updateCursorByPos(const QPoint &localPos);
-    void clearAncestorCursors();
-    void setMouseTrackingRecursive(QWidget *w, bool on = true);
-    void installCursorEventFilterRecursive(QWidget *w);
+    static DragMode hitTest(const QSize &size, const QPoint &localPos);
     QRect applySnapping(const QRect &rect, QVector<QLine> *guides) const;
     void updateGuidelines(const QVector<QLine> &guides);
+    FormCanvas* canvas() const;
+    using PageFactory = std::function<void(QVBoxLayout *lay)>;
+    void addLazyTab(const QString &title, PageFactory factory);
+    void ensurePageBuilt(int index);
+    void buildTablePage(QVBoxLayout *lay);
+    void buildTextPage(QVBoxLayout *lay);
+    void buildLogPage(QVBoxLayout *lay);
+    static void populateDemoDataset(ColumnarTableModel *model);
+    bool applyTableModel();
+    static QString defaultText();
+    void processDragFrame();
+    void commitGeometry(const QRect &geom);
+    int frameInterval() const;
 
 private:
-    const int m_margin = 8;
-    const int m_minw   = 260;
-    const int m_minh   = 160;
+    const int m_minw   = MinimumWidth;
+    const int m_minh   = MinimumHeight;
     const int m_snapThreshold = 8;
 
+    int      m_formId = -1;
     DragMode m_dragMode = None;
     QPoint   m_pressGlobalPos;
     QRect    m_pressGeometry;
 
+    bool     m_groupDrag = false;
+    QRect    m_pressGroupBounds;
+
+    DragRenderMode m_dragRenderMode = LiveDrag;
+    bool     m_snapshotDrag = false;
+    QRect    m_previewGeometry;
+
+    QTimer  *m_frameTimer = nullptr;
+    QPoint   m_pendingGlobalPos;
+    int      m_pendingInputEvents = 0;
+    int      m_lastFrameCoalescedEvents = 0;
+    bool     m_committingGeometry = false;
+
+    struct LazyPage {
+        QWidget *page = nullptr;
+        PageFactory factory;        // 构建后置空
+    };
+
     QTabWidget *m_tabs = nullptr;
+    QVector<LazyPage> m_pages;
     QTableView *m_table = nullptr;
+    QSharedPointer<QAbstractItemModel> m_model;
+    QString     m_datasetPath;
+    QTextEdit  *m_textEdit = nullptr;
+    QSharedPointer<LogBuffer> m_log;
+    LogView    *m_logView = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "feedqueue.h"
+
+FeedQueue::FeedQueue(int capacity)
+{
+    quint64 size = 2;
+    while (size < quint64(qMax(2, capacity)))
+        size <<= 1;
+    m_mask = size - 1;
+    m_slots.reset(new Slot[size]);
+    for (quint64 i = 0; i < size; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool FeedQueue::push(const FeedUpdate &update)
+{
+    quint64 pos = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &slot = m_slots[pos & m_mask];
+        const quint64 seq = slot.sequence.load(std::memory_order_acquire);
+        const qint64 diff = qint64(seq) - qint64(pos);
+        if (diff == 0) {
+            // 槽位空闲：抢到尾指针后写入，再发布序号让消费者可见
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.value = update;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;   // 队列已满
+        } else {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool FeedQueue::pop(FeedUpdate *update)
+{
+    Slot &slot = m_slots[m_head & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+        return false;
+    *update = slot.value;
+    // 槽位留给一整圈之后的生产者
+    slot.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+    ++m_head;
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// 一条实时数据更新：写入某个数据源的某个单元格；行号超出现有行数即为追加行
+struct FeedUpdate
+{
+    int feed = 0;
+    int row = 0;
+    int column = 0;
+    double value = 0;
+};
+
+// 有界无锁队列，多生产者单消费者：任意线程 push，只有 GUI 线程 pop。
+// 每个槽位带序号，生产者只在尾指针上做一次 CAS，消费者不需要原子读改写；满时 push 失败，不阻塞
+class FeedQueue
+{
+public:
+    explicit FeedQueue(int capacity);   // 向上取整到 2 的幂
+
+    bool push(const FeedUpdate &update);
+    bool pop(FeedUpdate *update);
+    int capacity() const { return int(m_mask + 1); }
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence;
+        FeedUpdate value;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    quint64 m_mask = 0;
+    alignas(64) std::atomic<quint64> m_tail { 0 };   // 生产者共享
+    alignas(64) quint64 m_head = 0;                  // 消费者独占
+};
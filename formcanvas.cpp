@@ -1,9 +1,142 @@
 #include "formcanvas.h"
+#include "customform.h"
+#include "frameprofiler.h"
 
 #include <QPainter>
 #include <QPaintEvent>
 #include <QColor>
 #include <QPen>
+#include <QRegion>
+#include <QMouseEvent>
+#include <QShowEvent>
+#include <QWindow>
+#include <QTimer>
+#include <QFontMetrics>
+#include <QMoveEvent>
+#include <QStringList>
+#include <QRubberBand>
+#include <algorithm>
+
+// 拖拽预览：缩放绘制按下时抓取的快照并描边，不参与布局也不接收鼠标
+class DragPreviewOverlay : public QWidget
+{
+public:
+    explicit DragPreviewOverlay(QWidget *parent)
+        : QWidget(parent)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents, true);
+        setAttribute(Qt::WA_NoSystemBackground, true);
+        hide();
+    }
+
+    void setSnapshot(const QPixmap &snapshot)
+    {
+        m_snapshot = snapshot;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.setOpacity(0.85);
+        p.drawPixmap(rect(), m_snapshot);
+        p.setOpacity(1.0);
+
+        QPen pen(QColor(66, 133, 244, 220));
+        pen.setWidth(2);
+        p.setPen(pen);
+        p.drawRect(rect().adjusted(1, 1, -1, -1));
+    }
+
+private:
+    QPixmap m_snapshot;
+};
+
+// 性能统计浮层：定时取各分段的分位数绘制成表；不透明绘制，刷新时不牵动画布重绘
+class ProfilerHudOverlay : public QWidget
+{
+public:
+    explicit ProfilerHudOverlay(QWidget *parent)
+        : QWidget(parent)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents, true);
+        setAttribute(Qt::WA_OpaquePaintEvent, true);
+        QFont mono(QStringLiteral("monospace"));
+        mono.setStyleHint(QFont::TypeWriter);
+        setFont(mono);
+        m_timer = new QTimer(this);
+        m_timer->setInterval(250);
+        QObject::connect(m_timer, &QTimer::timeout, this, [this]() { refresh(); });
+        hide();
+    }
+
+    void start()
+    {
+        refresh();
+        show();
+        m_timer->start();
+    }
+
+    void stop()
+    {
+        m_timer->stop();
+        hide();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        p.fillRect(rect(), QColor(20, 20, 22, 255));
+        p.setPen(QColor(255, 255, 255, 60));
+        p.drawRect(rect().adjusted(0, 0, -1, -1));
+        p.setPen(QColor(220, 220, 220));
+        const int lineHeight = fontMetrics().height();
+        int y = 6 + fontMetrics().ascent();
+        for (const QString &line : std::as_const(m_lines)) {
+            p.drawText(8, y, line);
+            y += lineHeight;
+        }
+    }
+
+private:
+    void refresh()
+    {
+        // 分位数单位为微秒
+        m_lines.clear();
+        m_lines.append(QStringLiteral("%1 %2 %3 %4 %5")
+                       .arg(QStringLiteral("section"), -18)
+                       .arg(QStringLiteral("p50"), 8).arg(QStringLiteral("p95"), 8)
+                       .arg(QStringLiteral("p99"), 8).arg(QStringLiteral("n"), 6));
+        const FrameProfiler &profiler = FrameProfiler::instance();
+        for (int i = 0; i < FrameProfiler::SectionCount; ++i) {
+            const auto section = FrameProfiler::Section(i);
+            const FrameProfiler::Stats st = profiler.stats(section);
+            m_lines.append(QStringLiteral("%1 %2 %3 %4 %5")
+                           .arg(FrameProfiler::sectionName(section), -18)
+                           .arg(st.p50, 8, 'f', 1).arg(st.p95, 8, 'f', 1)
+                           .arg(st.p99, 8, 'f', 1).arg(st.count, 6));
+        }
+        // 每帧合并的输入数，单位为事件
+        const FrameProfiler::Stats coalesced = profiler.coalescedInputStats();
+        m_lines.append(QStringLiteral("%1 %2 %3 %4 %5")
+                       .arg(QStringLiteral("coalesced_input"), -18)
+                       .arg(coalesced.p50, 8, 'f', 1).arg(coalesced.p95, 8, 'f', 1)
+                       .arg(coalesced.p99, 8, 'f', 1).arg(coalesced.count, 6));
+
+        const QFontMetrics fm = fontMetrics();
+        int width = 0;
+        for (const QString &line : std::as_const(m_lines))
+            width = std::max(width, fm.horizontalAdvance(line));
+        resize(width + 16, fm.height() * int(m_lines.size()) + 12);
+        raise();
+        update();
+    }
+
+    QTimer *m_timer = nullptr;
+    QStringList m_lines;
+};
 
 FormCanvas::FormCanvas(QWidget *parent)
     : QWidget(parent)
@@ -12,46 +145,463 @@ FormCanvas::FormCanvas(QWidget *parent)
     setAutoFillBackground(true);
 }
 
+void FormCanvas::showDragPreview(const QPixmap &snapshot, const QRect &geom)
+{
+    if (!m_dragPreview)
+        m_dragPreview = new DragPreviewOverlay(this);
+    m_dragPreview->setSnapshot(snapshot);
+    m_dragPreview->setGeometry(geom);
+    m_dragPreview->raise();
+    m_dragPreview->show();
+}
+
+void FormCanvas::moveDragPreview(const QRect &geom)
+{
+    if (m_dragPreview)
+        m_dragPreview->setGeometry(geom);
+}
+
+void FormCanvas::hideDragPreview()
+{
+    if (!m_dragPreview)
+        return;
+    m_dragPreview->hide();
+    m_dragPreview->setSnapshot(QPixmap());
+}
+
+void FormCanvas::setPlaceholder(int id, const QRect &geom)
+{
+    const QRect old = m_placeholders.rect(id);
+    if (m_placeholders.contains(id) && old == geom)
+        return;
+    m_placeholders.insert(id, geom);
+    update(old);
+    update(geom);
+}
+
+void FormCanvas::removePlaceholder(int id)
+{
+    if (!m_placeholders.contains(id))
+        return;
+    update(m_placeholders.rect(id));
+    m_placeholders.remove(id);
+}
+
+void FormCanvas::clearPlaceholders()
+{
+    if (m_placeholders.size() == 0)
+        return;
+    m_placeholders.clear();
+    update();
+}
+
+void FormCanvas::setProfilerHudVisible(bool on)
+{
+    if (!on) {
+        if (m_profilerHud)
+            m_profilerHud->stop();
+        return;
+    }
+    if (!m_profilerHud)
+        m_profilerHud = new ProfilerHudOverlay(this);
+    placeProfilerHud();
+    m_profilerHud->start();
+}
+
+bool FormCanvas::isProfilerHudVisible() const
+{
+    return m_profilerHud && m_profilerHud->isVisible();
+}
+
+void FormCanvas::moveEvent(QMoveEvent *event)
+{
+    QWidget::moveEvent(event);
+    placeProfilerHud();
+}
+
+void FormCanvas::placeProfilerHud()
+{
+    // 画布在滚动区域里的位置是滚动偏移的相反数，浮层跟着视口走
+    if (m_profilerHud)
+        m_profilerHud->move(QPoint(8, 8) - pos());
+}
+
+void FormCanvas::setFormGeometry(int id, const QRect &geom)
+{
+    const bool selected = m_selection.contains(id);
+    if (selected && m_forms.contains(id))
+        update(selectionOutline(m_forms.rect(id)));
+    m_forms.insert(id, geom);
+    if (!m_snapExcluded.contains(id))
+        m_snapIndex.insert(id, geom);
+    if (selected)
+        update(selectionOutline(geom));
+    emit formsChanged();
+}
+
+void FormCanvas::removeForm(int id)
+{
+    if (m_selection.contains(id)) {
+        update(selectionOutline(m_forms.rect(id)));
+        m_selection.remove(id);
+        emit selectionChanged();
+    }
+    m_snapExcluded.remove(id);
+    m_snapIndex.remove(id);
+    m_forms.remove(id);
+    m_thumbnails.remove(id);
+    removePlaceholder(id);
+    emit formsChanged();
+}
+
+void FormCanvas::clearForms()
+{
+    const bool hadSelection = !m_selection.isEmpty();
+    m_selection.clear();
+    m_snapExcluded.clear();
+    m_snapIndex.clear();
+    m_forms.clear();
+    m_thumbnails.clear();
+    clearPlaceholders();
+    update();
+    if (hadSelection)
+        emit selectionChanged();
+    emit formsChanged();
+}
+
+void FormCanvas::setSelection(const QSet<int> &ids)
+{
+    if (ids == m_selection)
+        return;
+    updateSelectionOutlines(m_selection);
+    m_selection = ids;
+    updateSelectionOutlines(m_selection);
+    emit selectionChanged();
+}
+
+void FormCanvas::toggleSelected(int id)
+{
+    if (!m_forms.contains(id))
+        return;
+    QSet<int> ids = m_selection;
+    if (!ids.remove(id))
+        ids.insert(id);
+    setSelection(ids);
+}
+
+void FormCanvas::clearSelection()
+{
+    setSelection(QSet<int>());
+}
+
+QRect FormCanvas::selectionBounds() const
+{
+    QRect bounds;
+    for (int id : m_selection)
+        bounds = bounds.united(m_forms.rect(id));
+    return bounds;
+}
+
+void FormCanvas::setSnapExcluded(const QSet<int> &ids)
+{
+    for (int id : std::as_const(m_snapExcluded)) {
+        if (!ids.contains(id) && m_forms.contains(id))
+            m_snapIndex.insert(id, m_forms.rect(id));
+    }
+    for (int id : ids)
+        m_snapIndex.remove(id);
+    m_snapExcluded = ids;
+}
+
+QRect FormCanvas::selectionOutline(const QRect &geom)
+{
+    // 描边画在组件外侧，不会被组件自身盖住
+    return geom.adjusted(-4, -4, 4, 4);
+}
+
+void FormCanvas::updateSelectionOutlines(const QSet<int> &ids)
+{
+    if (ids.isEmpty())
+        return;
+    QRegion dirty;
+    for (int id : ids)
+        dirty += selectionOutline(m_forms.rect(id));
+    update(dirty);
+}
+
+void FormCanvas::mousePressEvent(QMouseEvent *event)
+{
+    // 在空白处（或占位上）按下开始框选
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    m_bandOrigin = event->pos();
+    m_bandActive = true;
+    if (!m_rubberBand)
+        m_rubberBand = new QRubberBand(QRubberBand::Rectangle, this);
+    m_rubberBand->setGeometry(QRect(m_bandOrigin, QSize()));
+    event->accept();
+}
+
+void FormCanvas::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_bandActive) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    m_rubberBand->setGeometry(QRect(m_bandOrigin, event->pos()).normalized());
+    if (!m_rubberBand->isVisible()) {
+        m_rubberBand->raise();
+        m_rubberBand->show();
+    }
+}
+
+void FormCanvas::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!m_bandActive || event->button() != Qt::LeftButton) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+    m_bandActive = false;
+    const QRect band = QRect(m_bandOrigin, event->pos()).normalized();
+    const bool additive = event->modifiers() & (Qt::ControlModifier | Qt::ShiftModifier);
+    const bool dragged = m_rubberBand->isVisible();
+    m_rubberBand->hide();
+
+    QSet<int> ids = additive ? m_selection : QSet<int>();
+    if (dragged) {
+        for (int id : m_forms.query(band))
+            ids.insert(id);
+    }
+    setSelection(ids);
+}
+
+void FormCanvas::attachForm(int id, CustomForm *form)
+{
+    m_liveForms.insert(id, QPointer<CustomForm>(form));
+    connect(form, &CustomForm::contentChanged, this, [this, id]() {
+        m_thumbnails.invalidate(id);
+        emit formsChanged();
+    });
+}
+
+void FormCanvas::detachForm(int id)
+{
+    CustomForm *form = m_liveForms.take(id).data();
+    if (form)
+        disconnect(form, &CustomForm::contentChanged, this, nullptr);
+    if (form && form == m_hoverForm)
+        setHoverCursor(nullptr, Qt::ArrowCursor);
+}
+
+void FormCanvas::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    watchWindow();
+}
+
+void FormCanvas::watchWindow()
+{
+    // 在顶层窗口上装一个过滤器即可看到整个窗口的鼠标移动，子部件无需鼠标跟踪
+    QWindow *handle = window()->windowHandle();
+    if (handle == m_hoverWindow)
+        return;
+    if (m_hoverWindow)
+        m_hoverWindow->removeEventFilter(this);
+    m_hoverWindow = handle;
+    if (m_hoverWindow)
+        m_hoverWindow->installEventFilter(this);
+}
+
+bool FormCanvas::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != m_hoverWindow)
+        return QWidget::eventFilter(watched, event);
+
+    switch (event->type()) {
+    case QEvent::MouseMove: {
+        // 按住按键时光标归正在拖拽的组件所有，不做判定
+        auto *me = static_cast<QMouseEvent*>(event);
+        if (me->buttons() == Qt::NoButton)
+            updateHoverCursor(me->globalPosition());
+        break;
+    }
+    case QEvent::MouseButtonRelease: {
+        auto *me = static_cast<QMouseEvent*>(event);
+        if (me->buttons() == Qt::NoButton) {
+            // 拖拽期间组件可能已移动或被回收，松开后从头判定
+            setHoverCursor(nullptr, Qt::ArrowCursor);
+            updateHoverCursor(me->globalPosition());
+        }
+        break;
+    }
+    case QEvent::Leave:
+        setHoverCursor(nullptr, Qt::ArrowCursor);
+        break;
+    default:
+        break;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void FormCanvas::updateHoverCursor(const QPointF &globalPos)
+{
+    // 画布被滚动区域裁剪，先确认指针落在可见的视口内
+    QWidget *viewport = parentWidget() ? parentWidget() : this;
+    const QPoint inViewport = viewport->mapFromGlobal(globalPos.toPoint());
+    if (!viewport->rect().contains(inViewport)) {
+        setHoverCursor(nullptr, Qt::ArrowCursor);
+        return;
+    }
+    const QPoint pos = viewport == this ? inViewport : inViewport - this->pos();
+
+    // 用缓存的组件几何命中测试，只看已实例化的组件
+    CustomForm *hit = nullptr;
+    int hitCount = 0;
+    for (int id : m_forms.query(QRect(pos, QSize(1, 1)))) {
+        CustomForm *form = m_liveForms.value(id).data();
+        if (!form || !form->isVisible())
+            continue;
+        hit = form;
+        ++hitCount;
+    }
+    if (hitCount > 1) {
+        // 组件重叠时按兄弟层叠顺序取最上层
+        hit = nullptr;
+        const QObjectList &siblings = children();
+        for (auto it = siblings.crbegin(); it != siblings.crend() && !hit; ++it) {
+            auto *form = qobject_cast<CustomForm*>(*it);
+            if (form && form->isVisible() && form->geometry().contains(pos))
+                hit = form;
+        }
+    }
+
+    if (!hit) {
+        setHoverCursor(nullptr, Qt::ArrowCursor);
+        return;
+    }
+    const QRect geom = hit->geometry();
+    setHoverCursor(hit, CustomForm::cursorShapeAt(geom.size(), pos - geom.topLeft()));
+}
+
+void FormCanvas::setHoverCursor(CustomForm *form, Qt::CursorShape shape)
+{
+    // 只在状态切换时才动光标
+    if (form == m_hoverForm && shape == m_hoverShape)
+        return;
+    if (m_hoverForm && m_hoverForm != form)
+        m_hoverForm->unsetCursor();
+    m_hoverForm = form;
+    m_hoverShape = shape;
+    if (!form)
+        return;
+    if (shape == Qt::ArrowCursor)
+        form->unsetCursor();
+    else
+        form->setCursor(shape);
+}
+
 void FormCanvas::setGuidelines(const QVector<QLine> &lines)
 {
     if (m_guidelines == lines)
         return;
+    // 只重绘新旧辅助线所在的细长区域
+    QRegion dirty;
+    for (const QLine &line : std::as_const(m_guidelines))
+        dirty += guidelineBounds(line);
     m_guidelines = lines;
-    update();
+    for (const QLine &line : std::as_const(m_guidelines))
+        dirty += guidelineBounds(line);
+    update(dirty);
 }
 
 void FormCanvas::clearGuidelines()
 {
     if (m_guidelines.isEmpty())
         return;
+    QRegion dirty;
+    for (const QLine &line : std::as_const(m_guidelines))
+        dirty += guidelineBounds(line);
     m_guidelines.clear();
-    update();
+    update(dirty);
+}
+
+QRect FormCanvas::guidelineBounds(const QLine &line)
+{
+    // 辅助线画笔宽 2，四周多留一点
+    return QRect(line.p1(), line.p2()).normalized().adjusted(-2, -2, 2, 2);
+}
+
+void FormCanvas::ensureGridTile()
+{
+    const qreal dpr = devicePixelRatioF();
+    if (!m_gridTile.isNull() && qFuzzyCompare(m_gridTile.devicePixelRatio(), dpr))
+        return;
+
+    // 一个网格单元的预渲染图块：背景 + 左侧与顶部各一条网格线
+    m_gridTile = QPixmap(QSize(m_gridSize, m_gridSize) * dpr);
+    m_gridTile.setDevicePixelRatio(dpr);
+    m_gridTile.fill(QColor("#1e1e1f"));
+
+    QPainter p(&m_gridTile);
+    p.setRenderHint(QPainter::Antialiasing, false);
+    QPen gridPen(QColor(255, 255, 255, 30));
+    gridPen.setWidth(1);
+    p.setPen(gridPen);
+    p.drawLine(0, 0, 0, m_gridSize);
+    p.drawLine(0, 0, m_gridSize, 0);
 }
 
 void FormCanvas::paintEvent(QPaintEvent *event)
 {
     QWidget::paintEvent(event);
+    ProfileScope scope(FrameProfiler::CanvasPaint);
+    ensureGridTile();
 
+    const QRect exposed = event->rect();
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setClipRegion(event->region());
 
-    // 背景网格
-    painter.fillRect(rect(), QColor("#1e1e1f"));
+    // 背景网格：按暴露区域平铺图块，图块原点与画布原点对齐
+    painter.drawTiledPixmap(exposed, m_gridTile,
+                            QPoint(exposed.x() % m_gridSize, exposed.y() % m_gridSize));
 
-    QPen gridPen(QColor(255, 255, 255, 30));
-    gridPen.setWidth(1);
-    painter.setPen(gridPen);
+    // 占位：与 CustomForm 相同的底色和边框
+    const QVector<int> placeholders = m_placeholders.query(exposed);
+    if (!placeholders.isEmpty()) {
+        QPen borderPen(QColor(255, 255, 255, 40));
+        borderPen.setWidth(1);
+        painter.setPen(borderPen);
+        painter.setBrush(QColor("#232324"));
+        for (int id : placeholders)
+            painter.drawRect(m_placeholders.rect(id).adjusted(0, 0, -1, -1));
+        painter.setBrush(Qt::NoBrush);
+    }
 
-    for (int x = 0; x <= width(); x += m_gridSize)
-        painter.drawLine(x, 0, x, height());
-    for (int y = 0; y <= height(); y += m_gridSize)
-        painter.drawLine(0, y, width(), y);
+    // 选中描边：只画与暴露区域相交的
+    if (!m_selection.isEmpty()) {
+        QPen selectPen(QColor(66, 133, 244, 230));
+        selectPen.setWidth(2);
+        painter.setPen(selectPen);
+        for (int id : m_forms.query(exposed.adjusted(-4, -4, 4, 4))) {
+            if (m_selection.contains(id))
+                painter.drawRect(m_forms.rect(id).adjusted(-2, -2, 1, 1));
+        }
+    }
 
     if (!m_guidelines.isEmpty()) {
         QPen guidePen(QColor(66, 133, 244, 180));
         guidePen.setWidth(2);
         painter.setPen(guidePen);
-        for (const QLine &line : m_guidelines)
-            painter.drawLine(line);
+        for (const QLine &line : m_guidelines) {
+            if (guidelineBounds(line).intersects(exposed))
+                painter.drawLine(line);
+        }
     }
+    painter.end();
+
+    if (FrameProfiler::isEnabled())
+        FrameProfiler::instance().markPresented();
 }
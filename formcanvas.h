@@ -3,6 +3,20 @@
 #include <QWidget>
 #include <QVector>
 #include <QLine>
+#include <QPixmap>
+#include <QPointer>
+#include <QHash>
+#include <QSet>
+
+#include "snapindex.h"
+#include "spatialgrid.h"
+#include "thumbnailcache.h"
+
+class DragPreviewOverlay;
+class ProfilerHudOverlay;
+class CustomForm;
+class QWindow;
+class QRubberBand;
 
 class FormCanvas : public QWidget
 {
@@ -15,10 +29,92 @@ public:
 
     int gridSize() const { return m_gridSize; }
 
+    // 快照拖拽时在所有组件之上显示的轻量预览
+    void showDragPreview(const QPixmap &snapshot, const QRect &geom);
+    void moveDragPreview(const QRect &geom);
+    void hideDragPreview();
+
+    // 未实例化组件的占位矩形，仅在暴露区域内廉价绘制
+    void setPlaceholder(int id, const QRect &geom);
+    void removePlaceholder(int id);
+    void clearPlaceholders();
+
+    SnapIndex &snapIndex() { return m_snapIndex; }
+    const SnapIndex &snapIndex() const { return m_snapIndex; }
+
+    // 全部组件（含未实例化的）的几何：同时维护吸附索引与网格分桶，选中组件的描边随之重绘
+    void setFormGeometry(int id, const QRect &geom);
+    void removeForm(int id);
+    void clearForms();
+    const SpatialGrid &formGrid() const { return m_forms; }
+
+    // 多选：框选或按住 Ctrl/Shift 点选
+    const QSet<int> &selection() const { return m_selection; }
+    bool isSelected(int id) const { return m_selection.contains(id); }
+    void setSelection(const QSet<int> &ids);
+    void toggleSelected(int id);
+    void clearSelection();
+    QRect selectionBounds() const;
+
+    // 群组拖拽期间把组内组件移出吸附索引，组内不互相吸附；避让模式下排除被推开的组件。传空集合恢复
+    void setSnapExcluded(const QSet<int> &ids);
+    const QSet<int> &snapExcluded() const { return m_snapExcluded; }
+
+    // 性能统计浮层，固定在视口左上角
+    void setProfilerHudVisible(bool on);
+    bool isProfilerHudVisible() const;
+
+    // 已实例化的组件登记到画布，由画布统一做悬停命中测试与光标切换
+    void attachForm(int id, CustomForm *form);
+    void detachForm(int id);
+    CustomForm *liveForm(int id) const { return m_liveForms.value(id).data(); }
+
+    // 缩略图只从已实例化的组件抓取；组件回收后旧图仍可用
+    ThumbnailCache &thumbnails() { return m_thumbnails; }
+
+signals:
+    void selectionChanged();
+    // 组件几何、增删或缩略图失效，概览视图据此节流重绘
+    void formsChanged();
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void moveEvent(QMoveEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    static QRect guidelineBounds(const QLine &line);
+    static QRect selectionOutline(const QRect &geom);
+    void updateSelectionOutlines(const QSet<int> &ids);
+    void ensureGridTile();
+    void watchWindow();
+    void placeProfilerHud();
+    void updateHoverCursor(const QPointF &globalPos);
+    void setHoverCursor(CustomForm *form, Qt::CursorShape shape);
 
 private:
     QVector<QLine> m_guidelines;
+    QPixmap m_gridTile;
+    DragPreviewOverlay *m_dragPreview = nullptr;
+    ProfilerHudOverlay *m_profilerHud = nullptr;
+    SnapIndex m_snapIndex;
+    SpatialGrid m_placeholders;
+    SpatialGrid m_forms;
+    QHash<int, QPointer<CustomForm>> m_liveForms;
+    QSet<int> m_selection;
+    QSet<int> m_snapExcluded;
+    ThumbnailCache m_thumbnails;
+
+    QRubberBand *m_rubberBand = nullptr;
+    QPoint m_bandOrigin;
+    bool m_bandActive = false;
+
+    QPointer<QWindow> m_hoverWindow;
+    QPointer<CustomForm> m_hoverForm;
+    Qt::CursorShape m_hoverShape = Qt::ArrowCursor;
     const int m_gridSize = 20;
 };
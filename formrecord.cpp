@@ -0,0 +1,30 @@
+#include "formrecord.h"
+
+#include <algorithm>
+
+QJsonObject formRecordToJson(const FormRecord &rec)
+{
+    QJsonObject obj;
+    obj["x"] = rec.geometry.x();
+    obj["y"] = rec.geometry.y();
+    obj["w"] = rec.geometry.width();
+    obj["h"] = rec.geometry.height();
+    if (rec.page != 0)
+        obj["page"] = rec.page;
+    if (!rec.state.isEmpty())
+        obj["state"] = rec.state;
+    return obj;
+}
+
+FormRecord formRecordFromJson(const QJsonObject &obj)
+{
+    FormRecord rec;
+    rec.page = std::max(0, obj.value("page").toInt(0));
+    const int x = obj.value("x").toInt();
+    const int y = obj.value("y").toInt();
+    const int w = obj.value("w").toInt(420);
+    const int h = obj.value("h").toInt(280);
+    rec.geometry = QRect(x, y, std::max(w, 1), std::max(h, 1));
+    rec.state = obj.value("state").toObject();
+    return rec;
+}
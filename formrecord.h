@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QRect>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 组件的轻量记录：布局、吸附、保存都基于它；CustomForm 只在视口附近按需实例化
+struct FormRecord
+{
+    int id = -1;
+    int page = 0;           // 所属工作区页面
+    QRect geometry;
+    QJsonObject state;
+};
+
+// 布局文件中单个组件的 JSON 表示：{"x","y","w","h","page","state"}，page 为 0 时省略
+QJsonObject formRecordToJson(const FormRecord &rec);
+FormRecord formRecordFromJson(const QJsonObject &obj);
+
+// 一份布局的全部内容：组件记录，以及按页号排列的页面名称。
+// 只有一页且未改名时 pageNames 为空；名称为空串的页面使用默认名称
+struct LayoutDocument
+{
+    QVector<FormRecord> records;
+    QStringList pageNames;
+};
@@ -0,0 +1,154 @@
+#include "frameprofiler.h"
+
+#include <QSaveFile>
+#include <QTextStream>
+#include <algorithm>
+
+FrameProfiler::FrameProfiler()
+{
+    m_clock.start();
+}
+
+FrameProfiler &FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+void FrameProfiler::setEnabled(bool on)
+{
+    if (on == s_enabled)
+        return;
+    s_enabled = on;
+    instance().m_pendingInput = -1;
+}
+
+QString FrameProfiler::sectionName(Section section)
+{
+    switch (section) {
+    case DragFrame:       return QStringLiteral("drag_frame");
+    case Snapping:        return QStringLiteral("snapping");
+    case GeometryCommit:  return QStringLiteral("geometry_commit");
+    case Guidelines:      return QStringLiteral("guidelines");
+    case ContainerResize: return QStringLiteral("container_resize");
+    case CanvasPaint:     return QStringLiteral("canvas_paint");
+    case InputLatency:    return QStringLiteral("input_latency");
+    default:              return QString();
+    }
+}
+
+void FrameProfiler::append(Series &series, const Sample &sample)
+{
+    if (series.samples.size() < kSamplesPerSection) {
+        series.samples.append(sample);
+        return;
+    }
+    series.samples[series.next] = sample;
+    series.next = (series.next + 1) % kSamplesPerSection;
+}
+
+void FrameProfiler::addSample(Section section, qint64 startNs, qint64 durationNs)
+{
+    append(m_series[section], {startNs, durationNs});
+}
+
+void FrameProfiler::markInput()
+{
+    if (s_enabled && m_pendingInput < 0)
+        m_pendingInput = now();
+}
+
+void FrameProfiler::markPresented()
+{
+    if (!s_enabled || m_pendingInput < 0)
+        return;
+    addSample(InputLatency, m_pendingInput, now() - m_pendingInput);
+    m_pendingInput = -1;
+}
+
+void FrameProfiler::addCoalescedInput(int events)
+{
+    if (s_enabled)
+        append(m_coalescedInput, {now(), events});
+}
+
+FrameProfiler::Stats FrameProfiler::stats(Section section) const
+{
+    // 样本为纳秒，输出微秒
+    return computeStats(m_series[section], 1000.0);
+}
+
+FrameProfiler::Stats FrameProfiler::coalescedInputStats() const
+{
+    return computeStats(m_coalescedInput, 1.0);
+}
+
+FrameProfiler::Stats FrameProfiler::computeStats(const Series &series, double scale)
+{
+    Stats st;
+    const QVector<Sample> &samples = series.samples;
+    if (samples.isEmpty())
+        return st;
+
+    QVector<qint64> d;
+    d.reserve(samples.size());
+    for (const Sample &s : samples)
+        d.append(s.duration);
+
+    auto percentile = [&d, scale](double q) {
+        const int k = std::min(int(d.size()) - 1, int(q * d.size()));
+        std::nth_element(d.begin(), d.begin() + k, d.end());
+        return d.at(k) / scale;
+    };
+    st.count = int(d.size());
+    st.p50 = percentile(0.50);
+    st.p95 = percentile(0.95);
+    st.p99 = percentile(0.99);
+    st.max = *std::max_element(d.cbegin(), d.cend()) / scale;
+    return st;
+}
+
+void FrameProfiler::reset()
+{
+    for (Series &s : m_series) {
+        s.samples.clear();
+        s.next = 0;
+    }
+    m_coalescedInput.samples.clear();
+    m_coalescedInput.next = 0;
+    m_pendingInput = -1;
+}
+
+bool FrameProfiler::exportCsv(const QString &fileName, QString *error) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "section,start_us,value\n";
+    for (int i = 0; i < SectionCount; ++i) {
+        const Series &s = m_series[i];
+        const QString name = sectionName(Section(i));
+        // 环形缓冲按时间顺序输出：从最旧的一条开始
+        for (int k = 0; k < s.samples.size(); ++k) {
+            const Sample &sample = s.samples.at((s.next + k) % s.samples.size());
+            out << name << ',' << sample.start / 1000.0 << ',' << sample.duration / 1000.0 << '\n';
+        }
+    }
+    for (int k = 0; k < m_coalescedInput.samples.size(); ++k) {
+        const Sample &sample = m_coalescedInput.samples.at((m_coalescedInput.next + k) % m_coalescedInput.samples.size());
+        out << "coalesced_input," << sample.start / 1000.0 << ',' << sample.duration << '\n';
+    }
+    out.flush();
+
+    if (!file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
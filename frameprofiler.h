@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+// 拖拽热点路径的耗时统计：每个分段保留最近若干样本，按需计算分位数
+// 只在 GUI 线程使用；关闭时 ProfileScope 只多一次布尔判断
+class FrameProfiler
+{
+public:
+    enum Section {
+        DragFrame,          // 一次 processDragFrame 的总耗时
+        Snapping,
+        GeometryCommit,
+        Guidelines,
+        ContainerResize,
+        CanvasPaint,
+        InputLatency,       // 输入事件到随后第一次绘制完成
+        SectionCount
+    };
+
+    struct Stats {
+        int    count = 0;
+        double p50 = 0, p95 = 0, p99 = 0, max = 0;    // 微秒
+    };
+
+    static constexpr int kSamplesPerSection = 4096;
+
+    static FrameProfiler &instance();
+    static bool isEnabled() { return s_enabled; }
+    static void setEnabled(bool on);
+
+    static QString sectionName(Section section);
+
+    void addSample(Section section, qint64 startNs, qint64 durationNs);
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+
+    // 输入到绘制的延迟：记下最早一次尚未呈现的输入，绘制结束时结算
+    void markInput();
+    void markPresented();
+
+    // 每个拖拽帧合并掉的鼠标输入数，与耗时分段分开统计
+    void addCoalescedInput(int events);
+
+    Stats stats(Section section) const;
+    // 单位为事件数而非微秒
+    Stats coalescedInputStats() const;
+    void reset();
+
+    // 原始样本导出为 CSV：section,start_us,value；耗时分段的 value 为微秒，coalesced_input 为事件数
+    bool exportCsv(const QString &fileName, QString *error = nullptr) const;
+
+private:
+    FrameProfiler();
+
+    struct Sample {
+        qint64 start = 0;
+        qint64 duration = 0;
+    };
+
+    struct Series {
+        QVector<Sample> samples;    // 环形缓冲
+        int next = 0;
+    };
+
+    static void append(Series &series, const Sample &sample);
+    static Stats computeStats(const Series &series, double scale);
+
+    static inline bool s_enabled = false;
+
+    QElapsedTimer m_clock;
+    Series m_series[SectionCount];
+    Series m_coalescedInput;        // Sample::duration 存事件数
+    qint64 m_pendingInput = -1;
+};
+
+// 作用域计时：构造时开始，析构时记入对应分段
+class ProfileScope
+{
+public:
+    explicit ProfileScope(FrameProfiler::Section section)
+        : m_section(section)
+    {
+        if (FrameProfiler::isEnabled())
+            m_start = FrameProfiler::instance().now();
+    }
+
+    ~ProfileScope()
+    {
+        if (m_start >= 0 && FrameProfiler::isEnabled()) {
+            FrameProfiler &p = FrameProfiler::instance();
+            p.addSample(m_section, m_start, p.now() - m_start);
+        }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    FrameProfiler::Section m_section;
+    qint64 m_start = -1;
+};
@@ -0,0 +1,108 @@
+#include "layoutfile.h"
+#include "binarylayout.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+
+bool readLayoutFile(const QString &fileName, LayoutDocument *layout, QString *error)
+{
+    QVector<FormRecord> *records = &layout->records;
+    records->clear();
+    layout->pageNames.clear();
+
+    if (BinaryLayout::isBinaryLayoutFile(fileName)) {
+        BinaryLayout binary;
+        if (!binary.open(fileName)) {
+            if (error)
+                *error = binary.errorString();
+            return false;
+        }
+        records->reserve(binary.count());
+        for (int i = 0; i < binary.count(); ++i)
+            records->append(binary.record(i));
+        layout->pageNames = binary.pageNames();
+        return true;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QJsonArray arr;
+    if (doc.isArray()) {
+        arr = doc.array();
+    } else if (doc.isObject()) {
+        const QJsonObject root = doc.object();
+        arr = root.value("forms").toArray();
+        for (const QJsonValue &name : root.value("pages").toArray())
+            layout->pageNames.append(name.toString());
+    } else {
+        if (error)
+            *error = QObject::tr("文件格式不正确");
+        return false;
+    }
+    records->reserve(arr.size());
+    for (const QJsonValue &value : arr) {
+        if (value.isObject())
+            records->append(formRecordFromJson(value.toObject()));
+    }
+    return true;
+}
+
+bool writeLayoutFile(const QString &fileName, const LayoutDocument &layout, QString *error)
+{
+    // 先写临时文件，全部成功后再原子替换，中途失败或崩溃不会留下截断的布局
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    if (BinaryLayout::isBinaryLayoutFile(fileName)) {
+        if (!BinaryLayout::write(&file, layout.records, layout.pageNames, error)) {
+            file.cancelWriting();
+            return false;
+        }
+    } else {
+        QJsonArray arr;
+        for (const FormRecord &rec : layout.records)
+            arr.append(formRecordToJson(rec));
+        QJsonDocument doc(arr);
+        if (!layout.pageNames.isEmpty()) {
+            QJsonObject root;
+            root["pages"] = QJsonArray::fromStringList(layout.pageNames);
+            root["forms"] = arr;
+            doc = QJsonDocument(root);
+        }
+        const QByteArray data = doc.toJson(QJsonDocument::Indented);
+        if (file.write(data) != data.size()) {
+            if (error)
+                *error = file.errorString();
+            file.cancelWriting();
+            return false;
+        }
+    }
+
+    if (!file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool convertLayoutFile(const QString &from, const QString &to, QString *error)
+{
+    LayoutDocument layout;
+    if (!readLayoutFile(from, &layout, error))
+        return false;
+    return writeLayoutFile(to, layout, error);
+}
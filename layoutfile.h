@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "formrecord.h"
+
+// 布局文件读写，按扩展名选择格式：.tlay 为二进制（见 BinaryLayout），其余为 JSON。
+// JSON 没有页面名称时顶层是组件数组；有页面名称时顶层为 {"pages": [名称…], "forms": [组件…]}，
+// 旧版本会把它当作格式错误拒绝，而不是把页面误读成组件。
+// 写入通过 QSaveFile 原子替换；可在工作线程调用
+bool readLayoutFile(const QString &fileName, LayoutDocument *layout, QString *error = nullptr);
+bool writeLayoutFile(const QString &fileName, const LayoutDocument &layout, QString *error = nullptr);
+
+// 两种格式互转，目标格式同样由扩展名决定
+bool convertLayoutFile(const QString &from, const QString &to, QString *error = nullptr);
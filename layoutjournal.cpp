@@ -0,0 +1,244 @@
+#include "layoutjournal.h"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThread>
+#include <QtEndian>
+
+namespace {
+constexpr int kEntryHeaderSize = 1 + 4 * 5 + 4;
+
+void appendI32(QByteArray &out, qint32 v)
+{
+    uchar buf[4];
+    qToLittleEndian<qint32>(v, buf);
+    out.append(reinterpret_cast<const char*>(buf), 4);
+}
+
+QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+}
+
+LayoutJournal::LayoutJournal(const QString &dir, QObject *parent)
+    : QObject(parent)
+    , m_dir(dir)
+{
+    QDir().mkpath(m_dir);
+}
+
+LayoutJournal::~LayoutJournal()
+{
+    // 等待进行中的压缩写完，下次启动仍能从快照 + 日志恢复
+    if (m_compactor) {
+        m_compactor->wait();
+        delete m_compactor;
+    }
+}
+
+QString LayoutJournal::path(const char *name) const
+{
+    return m_dir + QLatin1Char('/') + QLatin1String(name);
+}
+
+LayoutDocument LayoutJournal::replay()
+{
+    // 重放是幂等的：Upsert/Remove/Pages 都是绝对值，快照之后再重放一遍 journal.prev 也得到同样结果
+    QMap<int, FormRecord> records;
+    LayoutDocument result;
+    apply(readFile(path("snapshot.bin")), &records, &result.pageNames);
+    apply(readFile(path("journal.prev")), &records, &result.pageNames);
+    apply(readFile(path("journal.bin")), &records, &result.pageNames);
+
+    m_journal.close();
+    m_journal.setFileName(path("journal.bin"));
+    m_journal.open(QIODevice::WriteOnly | QIODevice::Append);
+
+    result.records.reserve(records.size());
+    for (const FormRecord &rec : std::as_const(records))
+        result.records.append(rec);
+    return result;
+}
+
+void LayoutJournal::recordUpsert(const FormRecord &rec)
+{
+    append(encode(Upsert, rec));
+}
+
+void LayoutJournal::recordRemove(int id)
+{
+    FormRecord rec;
+    rec.id = id;
+    append(encode(Remove, rec));
+}
+
+void LayoutJournal::recordClear()
+{
+    append(encode(Clear, FormRecord()));
+}
+
+void LayoutJournal::recordPages(const QStringList &pageNames)
+{
+    append(encodePages(pageNames));
+}
+
+QByteArray LayoutJournal::encode(Op op, const FormRecord &rec)
+{
+    if (op == Upsert && rec.page != 0)
+        op = UpsertPaged;
+    const bool upsert = op == Upsert || op == UpsertPaged;
+    const QByteArray state = (upsert && !rec.state.isEmpty())
+            ? QJsonDocument(rec.state).toJson(QJsonDocument::Compact) : QByteArray();
+    QByteArray out;
+    out.reserve(kEntryHeaderSize + 4 + state.size());
+    out.append(char(op));
+    appendI32(out, rec.id);
+    appendI32(out, rec.geometry.x());
+    appendI32(out, rec.geometry.y());
+    appendI32(out, rec.geometry.width());
+    appendI32(out, rec.geometry.height());
+    appendI32(out, qint32(state.size()));
+    if (op == UpsertPaged)
+        appendI32(out, rec.page);
+    out += state;
+    return out;
+}
+
+QByteArray LayoutJournal::encodePages(const QStringList &pageNames)
+{
+    const QByteArray names = QJsonDocument(QJsonArray::fromStringList(pageNames)).toJson(QJsonDocument::Compact);
+    QByteArray out;
+    out.reserve(kEntryHeaderSize + names.size());
+    out.append(char(Pages));
+    for (int i = 0; i < 5; ++i)
+        appendI32(out, 0);
+    appendI32(out, qint32(names.size()));
+    out += names;
+    return out;
+}
+
+void LayoutJournal::apply(const QByteArray &data, QMap<int, FormRecord> *records, QStringList *pageNames)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(data.constData());
+    const qint64 size = data.size();
+    qint64 pos = 0;
+    // 末尾不完整的记录（写到一半崩溃）直接忽略
+    while (pos + kEntryHeaderSize <= size) {
+        const quint8 op = p[pos];
+        const qint32 id = qFromLittleEndian<qint32>(p + pos + 1);
+        const QRect geom(qFromLittleEndian<qint32>(p + pos + 5), qFromLittleEndian<qint32>(p + pos + 9),
+                         qFromLittleEndian<qint32>(p + pos + 13), qFromLittleEndian<qint32>(p + pos + 17));
+        const qint32 stateSize = qFromLittleEndian<qint32>(p + pos + 21);
+        const int headerSize = op == UpsertPaged ? kEntryHeaderSize + 4 : kEntryHeaderSize;
+        if (stateSize < 0 || pos + headerSize + stateSize > size)
+            break;
+
+        switch (op) {
+        case Upsert:
+        case UpsertPaged: {
+            FormRecord &rec = (*records)[id];
+            rec.id = id;
+            rec.page = op == UpsertPaged ? qFromLittleEndian<qint32>(p + pos + kEntryHeaderSize) : 0;
+            rec.geometry = geom;
+            rec.state = QJsonObject();
+            if (stateSize > 0) {
+                const QByteArray json = QByteArray::fromRawData(data.constData() + pos + headerSize, stateSize);
+                rec.state = QJsonDocument::fromJson(json).object();
+            }
+            break;
+        }
+        case Remove:
+            records->remove(id);
+            break;
+        case Clear:
+            records->clear();
+            pageNames->clear();
+            break;
+        case Pages: {
+            pageNames->clear();
+            const QByteArray json = QByteArray::fromRawData(data.constData() + pos + headerSize, stateSize);
+            for (const QJsonValue &name : QJsonDocument::fromJson(json).array())
+                pageNames->append(name.toString());
+            break;
+        }
+        default:
+            return;
+        }
+        pos += headerSize + stateSize;
+    }
+}
+
+bool LayoutJournal::writeSnapshot(const QString &fileName, const LayoutDocument &doc)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (!doc.pageNames.isEmpty() && file.write(encodePages(doc.pageNames)) < 0) {
+        file.cancelWriting();
+        return false;
+    }
+    for (const FormRecord &rec : doc.records) {
+        if (file.write(encode(Upsert, rec)) < 0) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+    return file.commit();
+}
+
+void LayoutJournal::append(const QByteArray &entry)
+{
+    if (!m_journal.isOpen())
+        return;
+    m_journal.write(entry);
+    m_journal.flush();
+    maybeCompact();
+}
+
+void LayoutJournal::maybeCompact()
+{
+    if (m_compactor || !m_provider || m_journal.size() < m_compactThreshold)
+        return;
+
+    // 先轮转日志（改名是 O(1) 的），之后的编辑写入新日志；
+    // 快照写完前崩溃时，snapshot.bin + journal.prev + journal.bin 仍能完整恢复
+    m_journal.close();
+    if (QFile::exists(path("journal.prev"))) {
+        // 上次压缩失败留下的旧日志不能丢，把当前日志接在它后面（重放幂等，重复也无妨）
+        QFile prev(path("journal.prev"));
+        if (prev.open(QIODevice::WriteOnly | QIODevice::Append))
+            prev.write(readFile(path("journal.bin")));
+        prev.close();
+        QFile::remove(path("journal.bin"));
+    } else {
+        QFile::rename(path("journal.bin"), path("journal.prev"));
+    }
+    m_journal.setFileName(path("journal.bin"));
+    m_journal.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+    const LayoutDocument snapshot = m_provider();
+    const QString fileName = path("snapshot.bin");
+    m_compactor = QThread::create([this, snapshot, fileName]() {
+        const bool ok = writeSnapshot(fileName, snapshot);
+        QMetaObject::invokeMethod(this, [this, ok]() { finishCompaction(ok); }, Qt::QueuedConnection);
+    });
+    m_compactor->start(QThread::LowPriority);
+}
+
+void LayoutJournal::finishCompaction(bool ok)
+{
+    if (m_compactor) {
+        m_compactor->wait();
+        delete m_compactor;
+        m_compactor = nullptr;
+    }
+    // 快照写失败时保留 journal.prev，下次启动照样能重放
+    if (ok)
+        QFile::remove(path("journal.prev"));
+}
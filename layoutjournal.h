@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+#include "formrecord.h"
+
+class QThread;
+
+// 自动保存日志：每次已提交的几何变化追加一条小记录（O(1) 字节），
+// 超过阈值时在后台压缩成全量快照。启动时按 快照 -> 轮转日志 -> 当前日志 的顺序重放。
+//
+// 目录内的文件：
+//   snapshot.bin   全量快照（同样是日志格式，只含 Pages/Upsert/UpsertPaged），QSaveFile 原子写入
+//   journal.prev   压缩期间轮转出来的旧日志，快照写完后删除
+//   journal.bin    当前追加的日志
+// 日志记录：op u8 | id i32 | x i32 | y i32 | w i32 | h i32 | stateSize u32 | [page i32] | state（紧凑 JSON）
+// page 只出现在 UpsertPaged 中，第 0 页的组件仍写 Upsert，与旧日志兼容。
+// Pages 记录整份页面名称列表（id 与几何为 0，state 位置是紧凑 JSON 数组），空白页也靠它重建
+class LayoutJournal : public QObject
+{
+    Q_OBJECT
+public:
+    using SnapshotProvider = std::function<LayoutDocument()>;
+
+    explicit LayoutJournal(const QString &dir, QObject *parent = nullptr);
+    ~LayoutJournal() override;
+
+    // 读取上次会话的记录（保留 id）并打开日志准备追加
+    LayoutDocument replay();
+
+    void setSnapshotProvider(SnapshotProvider provider) { m_provider = std::move(provider); }
+    void setCompactThreshold(qint64 bytes) { m_compactThreshold = bytes; }
+
+    void recordUpsert(const FormRecord &rec);
+    void recordRemove(int id);
+    void recordClear();
+    // 页面增删、改名后写入完整的名称列表；列表很短，整份覆盖比逐项记录简单
+    void recordPages(const QStringList &pageNames);
+
+private:
+    enum Op : quint8 { Upsert = 1, Remove = 2, Clear = 3, UpsertPaged = 4, Pages = 5 };
+
+    static QByteArray encode(Op op, const FormRecord &rec);
+    static QByteArray encodePages(const QStringList &pageNames);
+    static void apply(const QByteArray &data, QMap<int, FormRecord> *records, QStringList *pageNames);
+    static bool writeSnapshot(const QString &fileName, const LayoutDocument &doc);
+
+    QString path(const char *name) const;
+    void append(const QByteArray &entry);
+    void maybeCompact();
+    void finishCompaction(bool ok);
+
+    QString m_dir;
+    QFile m_journal;
+    SnapshotProvider m_provider;
+    qint64 m_compactThreshold = 256 * 1024;
+    QThread *m_compactor = nullptr;
+};
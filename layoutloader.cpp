@@ -0,0 +1,239 @@
+#include "layoutloader.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+constexpr int kChunkSize = 64 * 1024;
+constexpr int kSliceBudgetMs = 8;           // 每轮最多占用的时间，保证界面可以穿插绘制与响应输入
+}
+
+LayoutLoader::LayoutLoader(QObject *parent)
+    : QObject(parent)
+{
+    m_sliceTimer = new QTimer(this);
+    m_sliceTimer->setSingleShot(true);
+    m_sliceTimer->setInterval(0);
+    connect(m_sliceTimer, &QTimer::timeout, this, &LayoutLoader::processSlice);
+}
+
+bool LayoutLoader::start(const QString &fileName)
+{
+    cancel();
+    m_error.clear();
+    m_buffer.clear();
+    m_scanPos = 0;
+    m_objectStart = -1;
+    m_stringStart = -1;
+    m_depth = 0;
+    m_pageNameCount = 0;
+    m_inString = false;
+    m_escape = false;
+    m_sawTop = false;
+    m_topObject = false;
+    m_key.clear();
+    m_section.clear();
+
+    m_binaryNext = 0;
+
+    if (BinaryLayout::isBinaryLayoutFile(fileName)) {
+        if (!m_binary.open(fileName)) {
+            m_error = m_binary.errorString();
+            return false;
+        }
+        m_sliceTimer->start();
+        return true;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_sliceTimer->start();
+    return true;
+}
+
+void LayoutLoader::cancel()
+{
+    m_sliceTimer->stop();
+    if (m_file.isOpen())
+        m_file.close();
+    m_binary.close();
+}
+
+bool LayoutLoader::isRunning() const
+{
+    return m_file.isOpen() || m_binary.isOpen();
+}
+
+void LayoutLoader::processSlice()
+{
+    if (m_binary.isOpen()) {
+        processBinarySlice();
+        return;
+    }
+    if (!m_file.isOpen())
+        return;
+
+    QElapsedTimer budget;
+    budget.start();
+
+    QVector<FormRecord> batch;
+    bool eof = false;
+    while (m_error.isEmpty() && budget.elapsed() < kSliceBudgetMs) {
+        const QByteArray chunk = m_file.read(kChunkSize);
+        if (chunk.isEmpty()) {
+            eof = true;
+            break;
+        }
+        m_buffer += chunk;
+        scanBuffer(&batch);
+    }
+
+    if (!batch.isEmpty())
+        emit recordsParsed(batch);
+    emit progress(m_file.pos(), m_file.size());
+
+    if (!m_error.isEmpty()) {
+        finish(false, m_error);
+    } else if (eof) {
+        if (!m_sawTop || m_depth != 0)
+            finish(false, tr("文件格式不正确"));
+        else
+            finish(true);
+    } else {
+        m_sliceTimer->start();
+    }
+}
+
+void LayoutLoader::processBinarySlice()
+{
+    QElapsedTimer budget;
+    budget.start();
+
+    if (m_binaryNext == 0) {
+        const QStringList names = m_binary.pageNames();
+        for (int i = 0; i < names.size(); ++i)
+            emit pageNameParsed(i, names.at(i));
+    }
+
+    QVector<FormRecord> batch;
+    const int count = m_binary.count();
+    while (m_binaryNext < count && budget.elapsed() < kSliceBudgetMs) {
+        // 每 256 条检查一次时间，避免计时本身成为开销
+        const int end = std::min(count, m_binaryNext + 256);
+        for (; m_binaryNext < end; ++m_binaryNext)
+            batch.append(m_binary.record(m_binaryNext));
+    }
+
+    if (!batch.isEmpty())
+        emit recordsParsed(batch);
+    emit progress(m_binaryNext, count);
+
+    if (m_binaryNext >= count)
+        finish(true);
+    else
+        m_sliceTimer->start();
+}
+
+void LayoutLoader::finish(bool ok, const QString &error)
+{
+    m_error = error;
+    m_file.close();
+    m_binary.close();
+    emit finished(ok);
+}
+
+void LayoutLoader::scanBuffer(QVector<FormRecord> *out)
+{
+    const char *data = m_buffer.constData();
+    const int size = int(m_buffer.size());
+    // 组件对象所在的深度：顶层数组里为 1，顶层对象的 "forms" 数组里为 2
+    auto recordDepth = [this]() { return m_topObject ? 2 : 1; };
+
+    for (int i = m_scanPos; i < size; ++i) {
+        const char ch = data[i];
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (ch == '\\') {
+                m_escape = true;
+            } else if (ch == '"') {
+                m_inString = false;
+                if (m_stringStart >= 0) {
+                    const QByteArray raw(data + m_stringStart, i - m_stringStart + 1);
+                    m_stringStart = -1;
+                    if (m_depth == 1) {
+                        m_key = raw.mid(1, raw.size() - 2);
+                    } else {
+                        // 名称可能含转义，借 QJsonDocument 解码
+                        const QJsonDocument doc = QJsonDocument::fromJson('[' + raw + ']');
+                        emit pageNameParsed(m_pageNameCount++, doc.array().at(0).toString());
+                    }
+                }
+            }
+            continue;
+        }
+
+        switch (ch) {
+        case '"':
+            m_inString = true;
+            if (m_topObject && (m_depth == 1 || (m_depth == 2 && m_section == "pages")))
+                m_stringStart = i;
+            break;
+        case '[':
+        case '{':
+            if (m_depth == 0) {
+                m_sawTop = true;
+                m_topObject = ch == '{';
+            } else if (m_topObject && m_depth == 1) {
+                m_section = ch == '[' ? m_key : QByteArray();
+            } else if (m_depth == recordDepth() && ch == '{' && (!m_topObject || m_section == "forms")) {
+                m_objectStart = i;
+            }
+            ++m_depth;
+            break;
+        case ']':
+        case '}':
+            --m_depth;
+            if (m_depth < 0) {
+                m_error = tr("文件格式不正确");
+                return;
+            }
+            if (m_depth == recordDepth() && ch == '}' && m_objectStart >= 0) {
+                QJsonParseError err;
+                const QJsonDocument doc = QJsonDocument::fromJson(
+                    QByteArray::fromRawData(data + m_objectStart, i - m_objectStart + 1), &err);
+                if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+                    m_error = tr("文件格式不正确");
+                    return;
+                }
+                out->append(formRecordFromJson(doc.object()));
+                m_objectStart = -1;
+            }
+            if (m_topObject && m_depth == 1)
+                m_section.clear();
+            break;
+        default:
+            break;
+        }
+    }
+
+    // 丢弃已消费的字节，只保留尚未闭合的对象或字符串
+    int keepFrom = size;
+    if (m_objectStart >= 0)
+        keepFrom = std::min(keepFrom, m_objectStart);
+    if (m_stringStart >= 0)
+        keepFrom = std::min(keepFrom, m_stringStart);
+    m_buffer.remove(0, keepFrom);
+    if (m_objectStart >= 0)
+        m_objectStart -= keepFrom;
+    if (m_stringStart >= 0)
+        m_stringStart -= keepFrom;
+    m_scanPos = int(m_buffer.size());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QByteArray>
+#include <QVector>
+
+#include "formrecord.h"
+#include "binarylayout.h"
+
+class QTimer;
+
+// 分时流式加载布局：每个事件循环轮次只读取并解析一小段文件，
+// 按批交出组件记录，界面在加载过程中保持可交互，可随时取消。
+// 页面名称单独交出，可能早于或晚于组件记录（JSON 顶层对象里 "pages" 与 "forms" 的先后不定）。
+// .tlay 二进制布局走内存映射，按记录区间分批交出
+class LayoutLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LayoutLoader(QObject *parent = nullptr);
+
+    bool start(const QString &fileName);
+    void cancel();
+    bool isRunning() const;
+    QString errorString() const { return m_error; }
+
+signals:
+    void recordsParsed(const QVector<FormRecord> &records);
+    void pageNameParsed(int page, const QString &name);
+    void progress(qint64 done, qint64 total);
+    void finished(bool ok);
+
+private:
+    void processSlice();
+    void finish(bool ok, const QString &error = QString());
+    void scanBuffer(QVector<FormRecord> *out);
+    void processBinarySlice();
+
+    QFile m_file;
+    QTimer *m_sliceTimer = nullptr;
+    QString m_error;
+
+    BinaryLayout m_binary;
+    int m_binaryNext = 0;
+
+    // 增量 JSON 扫描状态：只追踪字符串/转义/嵌套深度，遇到完整的组件对象再交给 QJsonDocument。
+    // 顶层可以是组件数组，也可以是 {"pages": [...], "forms": [...]}
+    QByteArray m_buffer;
+    int  m_scanPos = 0;
+    int  m_objectStart = -1;
+    int  m_stringStart = -1;        // 需要取值的字符串（顶层键或页面名称）的起点
+    int  m_depth = 0;
+    int  m_pageNameCount = 0;
+    bool m_inString = false;
+    bool m_escape = false;
+    bool m_sawTop = false;
+    bool m_topObject = false;
+    QByteArray m_key;               // 顶层对象里最近读到的字符串，'[' 紧随其后时即为数组的键
+    QByteArray m_section;           // 当前所在的顶层数组的键
+};
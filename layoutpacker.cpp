@@ -0,0 +1,145 @@
+#include "layoutpacker.h"
+#include "spatialgrid.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+int alignUp(int v, int grid)
+{
+    const int r = v % grid;
+    if (r == 0)
+        return v;
+    return v >= 0 ? v + grid - r : v - r;
+}
+}
+
+SkylinePacker::SkylinePacker(int width, int gridSize, int gap)
+    : m_grid(std::max(1, gridSize))
+{
+    m_width = std::max(1, width / m_grid);
+    m_gapUnits = gap > 0 ? units(gap) : 0;
+    m_skyline.append({0, m_width, 0});
+}
+
+int SkylinePacker::units(int pixels) const
+{
+    return (std::max(0, pixels) + m_grid - 1) / m_grid;
+}
+
+QPoint SkylinePacker::insert(const QSize &size)
+{
+    // 占用尺寸包含右侧与下方的间距
+    const int w = std::min(units(size.width()) + m_gapUnits, m_width);
+    const int h = units(size.height()) + m_gapUnits;
+
+    int bestX = 0, bestY = -1;
+    for (int i = 0; i < m_skyline.size(); ++i) {
+        const int x = m_skyline.at(i).x;
+        if (x + w > m_width)
+            break;
+        // 跨越的各段中最高者决定落点高度
+        int y = 0, covered = 0;
+        for (int j = i; j < m_skyline.size() && covered < w; ++j) {
+            y = std::max(y, m_skyline.at(j).y);
+            covered += m_skyline.at(j).width;
+        }
+        if (bestY < 0 || y < bestY) {
+            bestY = y;
+            bestX = x;
+        }
+    }
+    if (bestY < 0)
+        bestY = 0;
+
+    place(bestX, bestY, w, h);
+    return QPoint(bestX * m_grid, bestY * m_grid);
+}
+
+void SkylinePacker::place(int x, int y, int w, int h)
+{
+    const int end = x + w;
+    QVector<Segment> next;
+    next.reserve(m_skyline.size() + 2);
+    bool inserted = false;
+    for (const Segment &s : std::as_const(m_skyline)) {
+        const int sEnd = s.x + s.width;
+        if (sEnd <= x || s.x >= end) {
+            if (!inserted && s.x >= end) {
+                next.append({x, w, y + h});
+                inserted = true;
+            }
+            next.append(s);
+            continue;
+        }
+        // 与新段重叠：保留左右露出的部分
+        if (s.x < x)
+            next.append({s.x, x - s.x, s.y});
+        if (!inserted) {
+            next.append({x, w, y + h});
+            inserted = true;
+        }
+        if (sEnd > end)
+            next.append({end, sEnd - end, s.y});
+    }
+    if (!inserted)
+        next.append({x, w, y + h});
+
+    // 合并等高的相邻段
+    m_skyline.clear();
+    for (const Segment &s : std::as_const(next)) {
+        if (!m_skyline.isEmpty() && m_skyline.last().y == s.y)
+            m_skyline.last().width += s.width;
+        else
+            m_skyline.append(s);
+    }
+}
+
+int SkylinePacker::height() const
+{
+    int h = 0;
+    for (const Segment &s : m_skyline)
+        h = std::max(h, s.y);
+    return h * m_grid;
+}
+
+QVector<QRect> SkylinePacker::pack(const QVector<QSize> &sizes, const QPoint &origin,
+                                   int width, int gridSize, int gap)
+{
+    QVector<int> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b) {
+        if (sizes.at(a).height() != sizes.at(b).height())
+            return sizes.at(a).height() > sizes.at(b).height();
+        return sizes.at(a).width() > sizes.at(b).width();
+    });
+
+    SkylinePacker packer(width, gridSize, gap);
+    QVector<QRect> result(sizes.size());
+    for (int i : std::as_const(order))
+        result[i] = QRect(origin + packer.insert(sizes.at(i)), sizes.at(i));
+    return result;
+}
+
+bool findFreeSpot(const SpatialGrid &forms, const QSize &size, const QRect &area,
+                  int gridSize, int gap, QPoint *topLeft)
+{
+    const int grid = std::max(1, gridSize);
+    for (int y = alignUp(area.top(), grid); y + size.height() - 1 <= area.bottom(); y += grid) {
+        int x = alignUp(area.left(), grid);
+        while (x + size.width() - 1 <= area.right()) {
+            const QRect probe(x - gap, y - gap, size.width() + 2 * gap, size.height() + 2 * gap);
+            const QVector<int> hits = forms.query(probe);
+            if (hits.isEmpty()) {
+                if (topLeft)
+                    *topLeft = QPoint(x, y);
+                return true;
+            }
+            int next = x + grid;
+            for (int id : hits)
+                next = std::max(next, forms.rect(id).right() + 1 + gap);
+            x = alignUp(next, grid);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+class SpatialGrid;
+
+// 天际线（skyline）装箱：以网格为单位，每次放到最低、其次最靠左的位置。
+// 天际线段数不超过宽度的网格数，插入代价与组件总数无关
+class SkylinePacker
+{
+public:
+    // width：可用宽度（像素）；gap：组件之间至少留出的间距（像素，向上取整到网格）
+    SkylinePacker(int width, int gridSize, int gap);
+
+    // 返回相对于装箱区域左上角的位置（像素，网格对齐）
+    QPoint insert(const QSize &size);
+    int height() const;     // 当前已用高度（像素）
+
+    // 批量装箱：先按高度降序放置，结果按输入顺序返回，原点为 origin
+    static QVector<QRect> pack(const QVector<QSize> &sizes, const QPoint &origin,
+                               int width, int gridSize, int gap);
+
+private:
+    struct Segment {
+        int x = 0;
+        int width = 0;
+        int y = 0;
+    };
+
+    int units(int pixels) const;
+    void place(int x, int y, int w, int h);
+
+    QVector<Segment> m_skyline;     // 按 x 递增，首尾相接覆盖整个宽度
+    int m_width = 0;                // 网格数
+    int m_grid = 1;
+    int m_gapUnits = 0;
+};
+
+// 在 area 内按行扫描网格点，找一个与已有组件（含间距）都不相交的位置；
+// 碰到组件时直接跳到其右侧，扫描量与区域内的组件数成正比
+bool findFreeSpot(const SpatialGrid &forms, const QSize &size, const QRect &area,
+                  int gridSize, int gap, QPoint *topLeft);
@@ -0,0 +1,65 @@
+#include "layoutsaver.h"
+#include "layoutfile.h"
+
+#include <QThread>
+
+LayoutSaver::LayoutSaver(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LayoutSaver::~LayoutSaver()
+{
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+void LayoutSaver::save(const QString &fileName, const LayoutDocument &snapshot)
+{
+    QMutexLocker lock(&m_mutex);
+    m_pending.insert(fileName, snapshot);   // 覆盖同一文件尚未写出的旧快照
+    if (m_busy)
+        return;
+    m_busy = true;
+    lock.unlock();
+
+    // 上一个工作线程已经（或即将）退出，回收后再开新的
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+    }
+    m_worker = QThread::create([this]() { run(); });
+    m_worker->start();
+}
+
+bool LayoutSaver::isBusy() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_busy;
+}
+
+void LayoutSaver::run()
+{
+    for (;;) {
+        QString fileName;
+        LayoutDocument layout;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_pending.isEmpty()) {
+                m_busy = false;
+                return;
+            }
+            auto it = m_pending.begin();
+            fileName = it.key();
+            layout = it.value();
+            m_pending.erase(it);
+        }
+
+        QString error;
+        const bool ok = writeLayoutFile(fileName, layout, &error);
+        QMetaObject::invokeMethod(this, [this, fileName, ok, error]() { emit saved(fileName, ok, error); },
+                                  Qt::QueuedConnection);
+    }
+}
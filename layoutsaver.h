@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QObject>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "formrecord.h"
+
+class QThread;
+
+// 后台保存布局：GUI 线程只交出记录与页面名称的快照，序列化与写盘在工作线程完成，
+// 通过 QSaveFile 原子替换目标文件。同一文件在写入期间的多次保存只写最新的快照
+class LayoutSaver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LayoutSaver(QObject *parent = nullptr);
+    ~LayoutSaver() override;   // 等待尚未写完的保存
+
+    void save(const QString &fileName, const LayoutDocument &snapshot);
+    bool isBusy() const;
+
+signals:
+    void saved(const QString &fileName, bool ok, const QString &error);
+
+private:
+    void run();
+
+    mutable QMutex m_mutex;
+    QMap<QString, LayoutDocument> m_pending;
+    bool m_busy = false;
+    QThread *m_worker = nullptr;
+};
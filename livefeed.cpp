@@ -0,0 +1,212 @@
+#include "livefeed.h"
+#include "columnartablemodel.h"
+
+#include <QGuiApplication>
+#include <QRandomGenerator>
+#include <QScreen>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <limits>
+
+LiveFeed::LiveFeed(QObject *parent)
+    : QObject(parent)
+    , m_queue(kQueueCapacity)
+{
+    m_models.reserve(kFeedCount);
+    for (int i = 0; i < kFeedCount; ++i)
+        m_models.append(ColumnarTableModel::shared(feedKey(i), &LiveFeed::populate));
+    m_batch.reserve(kMaxDrainPerFrame);
+
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_drainTimer, &QTimer::timeout, this, &LiveFeed::drain);
+}
+
+LiveFeed::~LiveFeed()
+{
+    stopSynthetic();
+}
+
+QString LiveFeed::feedKey(int feed)
+{
+    return QStringLiteral("feed:%1").arg(feed);
+}
+
+bool LiveFeed::isFeedKey(const QString &key)
+{
+    return key.startsWith(QLatin1String("feed:"));
+}
+
+void LiveFeed::populate(ColumnarTableModel *model)
+{
+    model->addColumn(QStringLiteral("编号"), ColumnarTableModel::NumberColumn);
+    model->addColumn(QStringLiteral("买价"), ColumnarTableModel::NumberColumn);
+    model->addColumn(QStringLiteral("卖价"), ColumnarTableModel::NumberColumn);
+    model->addColumn(QStringLiteral("成交价"), ColumnarTableModel::NumberColumn);
+    model->addColumn(QStringLiteral("成交量"), ColumnarTableModel::NumberColumn);
+    model->resizeRows(kInitialRows);
+    for (int r = 0; r < kInitialRows; ++r)
+        model->setNumber(r, 0, r + 1);
+    // 同一数据源被多个组件共享，且每帧都会被覆盖，视图里不允许编辑
+    model->setReadOnly(true);
+}
+
+void LiveFeed::start()
+{
+    const QScreen *s = QGuiApplication::primaryScreen();
+    const qreal hz = s ? s->refreshRate() : 60.0;
+    m_drainTimer->setInterval(hz > 0 ? std::max(1, qRound(1000.0 / hz)) : 16);
+    m_applied = 0;
+    m_dropped = 0;
+    m_rateClock.start();
+    m_drainTimer->start();
+}
+
+void LiveFeed::stop()
+{
+    m_drainTimer->stop();
+    drain();
+}
+
+bool LiveFeed::isRunning() const
+{
+    return m_drainTimer->isActive();
+}
+
+void LiveFeed::startSynthetic(int updatesPerSecond, int threads)
+{
+    stopSynthetic();
+    threads = std::clamp(threads, 1, int(kFeedCount));
+    const double perThread = double(std::max(1, updatesPerSecond)) / threads;
+    m_stop = false;
+    for (int t = 0; t < threads; ++t) {
+        QThread *producer = QThread::create([this, t, threads, perThread]() { produce(t, threads, perThread); });
+        producer->start();
+        m_producers.append(producer);
+    }
+    if (!isRunning())
+        start();
+}
+
+void LiveFeed::stopSynthetic()
+{
+    if (m_producers.isEmpty())
+        return;
+    m_stop = true;
+    for (QThread *producer : std::as_const(m_producers)) {
+        producer->wait();
+        delete producer;
+    }
+    m_producers.clear();
+}
+
+void LiveFeed::produce(int thread, int threads, double updatesPerSecond)
+{
+    // 每个线程独占一部分数据源，追加行的行号在线程内递增，不需要跨线程协调
+    QVector<int> feeds;
+    QVector<int> rows;
+    for (int f = thread; f < kFeedCount; f += threads) {
+        feeds.append(f);
+        rows.append(kInitialRows);
+    }
+    if (feeds.isEmpty())
+        return;
+
+    QRandomGenerator rng(quint32(0x5eed + thread));
+    QElapsedTimer clock;
+    clock.start();
+    qint64 sent = 0;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        // 按时间计算应发条数；落后太多时不补发，避免卡顿后突发
+        const qint64 due = qint64(double(clock.nsecsElapsed()) * updatesPerSecond / 1e9);
+        sent = std::max(sent, due - qint64(updatesPerSecond / 10));
+        if (sent >= due) {
+            QThread::usleep(500);
+            continue;
+        }
+        for (int i = 0; i < 256 && sent < due; ++i, ++sent) {
+            const int k = int(rng.bounded(quint32(feeds.size())));
+            FeedUpdate u;
+            u.feed = feeds.at(k);
+            if (rows.at(k) < kMaxRows && rng.bounded(64) == 0) {
+                u.row = rows[k]++;
+                u.column = 0;
+                u.value = u.row + 1;
+            } else {
+                u.row = int(rng.bounded(quint32(rows.at(k))));
+                u.column = 1 + int(rng.bounded(quint32(kColumns - 1)));
+                u.value = u.column == kColumns - 1 ? double(rng.bounded(10000))
+                                                   : 100.0 + rng.generateDouble() * 10.0;
+            }
+            if (!m_queue.push(u))
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void LiveFeed::drain()
+{
+    m_batch.clear();
+    FeedUpdate u;
+    while (m_batch.size() < kMaxDrainPerFrame && m_queue.pop(&u)) {
+        if (u.feed >= 0 && u.feed < kFeedCount && u.row >= 0 && u.row < kMaxRows
+                && u.column >= 0 && u.column < kColumns)
+            m_batch.append(u);
+    }
+    if (m_batch.isEmpty()) {
+        reportThroughput();
+        return;
+    }
+
+    struct Range {
+        int rows = 0;       // 本帧之前的行数
+        int needed = 0;     // 本帧需要的行数
+        int top = std::numeric_limits<int>::max();
+        int left = std::numeric_limits<int>::max();
+        int bottom = -1;
+        int right = -1;
+    };
+    Range ranges[kFeedCount];
+    for (int f = 0; f < kFeedCount; ++f) {
+        ranges[f].rows = m_models.at(f)->rowCount();
+        ranges[f].needed = ranges[f].rows;
+    }
+    for (const FeedUpdate &up : std::as_const(m_batch))
+        ranges[up.feed].needed = std::max(ranges[up.feed].needed, up.row + 1);
+
+    // 新行先一次性插入，再静默写值；只有原有行的改动需要 dataChanged，新行随插入一起显示
+    for (int f = 0; f < kFeedCount; ++f) {
+        if (ranges[f].needed > ranges[f].rows)
+            m_models.at(f)->appendRows(ranges[f].needed - ranges[f].rows);
+    }
+    for (const FeedUpdate &up : std::as_const(m_batch)) {
+        m_models.at(up.feed)->setNumber(up.row, up.column, up.value);
+        Range &r = ranges[up.feed];
+        if (up.row < r.rows) {
+            r.top = std::min(r.top, up.row);
+            r.bottom = std::max(r.bottom, up.row);
+            r.left = std::min(r.left, up.column);
+            r.right = std::max(r.right, up.column);
+        }
+    }
+    for (int f = 0; f < kFeedCount; ++f) {
+        const Range &r = ranges[f];
+        if (r.bottom >= 0)
+            m_models.at(f)->notifyCellsChanged(r.top, r.left, r.bottom, r.right);
+    }
+
+    m_applied += m_batch.size();
+    reportThroughput();
+}
+
+void LiveFeed::reportThroughput()
+{
+    const qint64 elapsed = m_rateClock.elapsed();
+    if (elapsed < 1000)
+        return;
+    const qint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    emit throughput(m_applied * 1000 / elapsed, dropped * 1000 / elapsed);
+    m_applied = 0;
+    m_rateClock.restart();
+}
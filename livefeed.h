@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "feedqueue.h"
+
+class QThread;
+class QTimer;
+class ColumnarTableModel;
+class FormBenchmark;
+
+// 实时数据源：生产者线程经无锁队列投递单元格更新，GUI 线程每帧取一次队列，
+// 每个数据源一帧只发一次批量 rowsInserted 与一次合并后的 dataChanged。
+// 组件把数据集设为 feedKey(n) 即订阅第 n 个数据源；数据源模型由这里持有，组件回收后数据仍在
+class LiveFeed : public QObject
+{
+    Q_OBJECT
+    friend class FormBenchmark;     // 基准程序直接按帧调用 drain()
+public:
+    static constexpr int kFeedCount = 16;
+    static constexpr int kColumns = 5;
+    static constexpr int kInitialRows = 20;
+    static constexpr int kMaxRows = 2000;                // 追加到此为止，之后只更新已有行
+    static constexpr int kQueueCapacity = 1 << 16;
+    static constexpr int kMaxDrainPerFrame = 1 << 16;   // 单帧最多应用的更新数，其余留到下一帧
+
+    explicit LiveFeed(QObject *parent = nullptr);
+    ~LiveFeed() override;   // 停止生成器线程
+
+    static QString feedKey(int feed);
+    static bool isFeedKey(const QString &key);
+    static void populate(ColumnarTableModel *model);
+
+    // 任意线程可调用；队列满时返回 false，由生产者决定重试还是丢弃
+    bool push(const FeedUpdate &update) { return m_queue.push(update); }
+
+    // 按屏幕刷新率取队列
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // 本地合成数据：threads 个生产者线程合计每秒 updatesPerSecond 条，各自负责一部分数据源
+    void startSynthetic(int updatesPerSecond, int threads);
+    void stopSynthetic();
+    bool isSyntheticRunning() const { return !m_producers.isEmpty(); }
+
+signals:
+    // 每秒一次：实际应用到模型的条数与因队列满而丢弃的条数
+    void throughput(qint64 appliedPerSecond, qint64 droppedPerSecond);
+
+private:
+    void drain();
+    void produce(int thread, int threads, double updatesPerSecond);
+    void reportThroughput();
+
+    FeedQueue m_queue;
+    QVector<QSharedPointer<ColumnarTableModel>> m_models;
+    QVector<FeedUpdate> m_batch;
+    QTimer *m_drainTimer = nullptr;
+
+    QVector<QThread*> m_producers;
+    std::atomic_bool m_stop { false };
+    std::atomic<qint64> m_dropped { 0 };
+
+    qint64 m_applied = 0;
+    QElapsedTimer m_rateClock;
+};
@@ -0,0 +1,156 @@
+#include "logview.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QScreen>
+#include <QScrollBar>
+#include <QTimer>
+#include <QFontMetrics>
+#include <QColor>
+#include <algorithm>
+
+LogBuffer::LogBuffer(int capacity)
+    : m_capacity(std::max(1, capacity))
+{
+}
+
+void LogBuffer::append(const QString &line)
+{
+    // 槽位在第一次追加时才分配，从不写日志的组件不占内存
+    const int cap = m_capacity;
+    if (m_lines.isEmpty())
+        m_lines.resize(cap);
+    int slot;
+    if (m_size < cap) {
+        slot = (m_head + m_size) % cap;
+        ++m_size;
+    } else {
+        slot = m_head;
+        m_head = (m_head + 1) % cap;
+    }
+    m_lines[slot] = line.size() > kMaxLineLength ? line.left(kMaxLineLength) : line;
+    ++m_total;
+}
+
+void LogBuffer::clear()
+{
+    m_lines = QVector<QString>();
+    m_head = 0;
+    m_size = 0;
+    m_total = 0;
+}
+
+const QString &LogBuffer::line(int index) const
+{
+    return m_lines.at((m_head + index) % m_capacity);
+}
+
+LogView::LogView(const LogBuffer *buffer, QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , m_buffer(buffer)
+{
+    QFont mono(QStringLiteral("monospace"));
+    mono.setStyleHint(QFont::TypeWriter);
+    setFont(mono);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent, true);
+    verticalScrollBar()->setSingleStep(1);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, viewport(), [this]() { viewport()->update(); });
+
+    // 帧节拍：单次定时器，一帧内的多次追加只刷新一次；间隔按所在屏幕的刷新率在启动时取
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, &QTimer::timeout, this, &LogView::refresh);
+
+    refresh();
+}
+
+void LogView::scheduleRefresh()
+{
+    if (!m_refreshTimer->isActive())
+        m_refreshTimer->start(frameInterval());
+}
+
+void LogView::setBuffer(const LogBuffer *buffer)
+{
+    if (buffer == m_buffer)
+        return;
+    m_buffer = buffer;
+    m_refreshTimer->stop();
+    m_firstShown = m_buffer->totalAppended() - quint64(m_buffer->size());
+    updateScrollRange();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    viewport()->update();
+    emit refreshed();
+}
+
+int LogView::frameInterval() const
+{
+    const QScreen *s = screen();
+    const qreal hz = s ? s->refreshRate() : 60.0;
+    return hz > 0 ? std::max(1, qRound(1000.0 / hz)) : 16;
+}
+
+int LogView::lineHeight() const
+{
+    return std::max(1, fontMetrics().height());
+}
+
+int LogView::visibleLines() const
+{
+    return std::max(1, viewport()->height() / lineHeight());
+}
+
+void LogView::updateScrollRange()
+{
+    QScrollBar *sb = verticalScrollBar();
+    sb->setPageStep(visibleLines());
+    sb->setRange(0, std::max(0, m_buffer->size() - visibleLines()));
+}
+
+void LogView::refresh()
+{
+    QScrollBar *sb = verticalScrollBar();
+    const bool follow = sb->value() >= sb->maximum();
+    const quint64 first = m_buffer->totalAppended() - quint64(m_buffer->size());
+    const int evicted = int(std::min<quint64>(first - std::min(first, m_firstShown), quint64(m_buffer->capacity())));
+    m_firstShown = first;
+
+    const int value = sb->value();
+    updateScrollRange();
+    // 跟随时贴底；否则按被挤出的行数上移，所看的行保持在原处
+    sb->setValue(follow ? sb->maximum() : value - evicted);
+    viewport()->update();
+    emit refreshed();
+}
+
+void LogView::resizeEvent(QResizeEvent *event)
+{
+    QScrollBar *sb = verticalScrollBar();
+    const bool follow = sb->value() >= sb->maximum();
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollRange();
+    if (follow)
+        sb->setValue(sb->maximum());
+}
+
+void LogView::paintEvent(QPaintEvent *event)
+{
+    QPainter p(viewport());
+    p.fillRect(event->rect(), QColor(28, 28, 30));
+    p.setPen(QColor(210, 210, 210));
+
+    // 只画与重绘区域相交的行
+    const int lh = lineHeight();
+    const int ascent = fontMetrics().ascent();
+    const int top = verticalScrollBar()->value();
+    const int from = std::max(0, event->rect().top() / lh);
+    const int to = event->rect().bottom() / lh;
+    for (int row = from; row <= to; ++row) {
+        const int index = top + row;
+        if (index >= m_buffer->size())
+            break;
+        p.drawText(4, row * lh + ascent, m_buffer->line(index));
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QString>
+#include <QVector>
+
+class QTimer;
+
+// 定长环形日志缓冲：满了覆盖最旧的行，超长的行截断，内存占用有固定上限
+class LogBuffer
+{
+public:
+    static constexpr int kDefaultCapacity = 5000;
+    static constexpr int kMaxLineLength = 400;
+
+    explicit LogBuffer(int capacity = kDefaultCapacity);
+
+    void append(const QString &line);
+    void clear();
+
+    int size() const { return m_size; }
+    int capacity() const { return m_capacity; }
+    const QString &line(int index) const;       // 0 为仍保留的最旧一行
+    quint64 totalAppended() const { return m_total; }
+
+private:
+    QVector<QString> m_lines;
+    int m_capacity = kDefaultCapacity;
+    int m_head = 0;
+    int m_size = 0;
+    quint64 m_total = 0;    // 累计追加行数，换算被挤出的行数
+};
+
+// 日志视图：纯文本、等行高，只绘制视口内的行。追加只写缓冲，
+// 视图每帧最多刷新一次；停在底部时跟随最新行，往上翻时保持所看内容不动
+class LogView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit LogView(const LogBuffer *buffer, QWidget *parent = nullptr);
+
+    // 缓冲有新内容后调用，合并到下一帧刷新
+    void scheduleRefresh();
+    // 换接另一个缓冲（组件复用时接回该 id 的日志），滚到最新行
+    void setBuffer(const LogBuffer *buffer);
+
+signals:
+    void refreshed();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void refresh();
+    void updateScrollRange();
+    int lineHeight() const;
+    int visibleLines() const;
+    int frameInterval() const;
+
+    const LogBuffer *m_buffer = nullptr;
+    QTimer *m_refreshTimer = nullptr;
+    quint64 m_firstShown = 0;   // 上次刷新时缓冲最旧一行的累计序号
+};
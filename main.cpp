@@ -1,11 +1,31 @@
 #include <QApplication>
+#include <QTextStream>
+#include <QStandardPaths>
 #include "mainwindow.h"
+#include "layoutfile.h"
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    // 布局格式转换：CustomFormParentDemo --convert <源文件> <目标文件>，格式由扩展名决定
+    const QStringList args = app.arguments();
+    if (args.size() == 4 && args.at(1) == QLatin1String("--convert")) {
+        QString error;
+        if (!convertLayoutFile(args.at(2), args.at(3), &error)) {
+            QTextStream(stderr) << "convert failed: " << error << Qt::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     MainWindow w;
+    // 对象池预热数量，可用环境变量 FORM_POOL_WARMUP 调整
+    bool ok = false;
+    const int warmup = qEnvironmentVariableIntValue("FORM_POOL_WARMUP", &ok);
+    w.warmUpFormPool(ok ? warmup : 16);
+    // 自动保存日志放在应用数据目录，启动时恢复上次会话
+    w.enableAutosave(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/autosave");
     w.show();
 
     return app.exec();
@@ -1,20 +1,62 @@
 #include "mainwindow.h"
 #include "customform.h"
 #include "formcanvas.h"
+#include "layoutloader.h"
+#include "layoutsaver.h"
+#include "layoutjournal.h"
+#include "frameprofiler.h"
+#include "undohistory.h"
+#include "layoutpacker.h"
+#include "minimapview.h"
+#include "livefeed.h"
 
 #include <QScrollArea>
+#include <QScrollBar>
+#include <QTimer>
+#include <QStatusBar>
+#include <QElapsedTimer>
+#include <QProgressBar>
+#include <QToolButton>
 #include <QToolBar>
 #include <QAction>
 #include <QVBoxLayout>
 #include <QFileDialog>
 #include <QFile>
-#include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QMessageBox>
+#include <QMenu>
+#include <QSignalBlocker>
+#include <QKeySequence>
+#include <QDockWidget>
+#include <QStackedWidget>
+#include <QTime>
+#include <QTabBar>
+#include <QInputDialog>
+#include <QLineEdit>
 #include <algorithm>
 
+namespace {
+constexpr QSize kMinCanvasSize(1400, 900);
+constexpr int kCanvasMargin = 40;
+// 视口外扩该距离内的组件实例化；超出释放距离才销毁，留出滞回
+constexpr int kMaterializeMargin = 400;
+constexpr int kReleaseMargin = 1200;
+// 对象池上限，超出的回收组件直接销毁
+constexpr int kMaxPooledForms = 512;
+// 单轮实例化的时间预算，超出后留到下一轮，优先实例化离视口中心最近的组件
+constexpr int kMaterializeBudgetMs = 8;
+// 合成实时数据的总速率与生产者线程数
+constexpr int kSyntheticFeedRate = 120000;
+constexpr int kSyntheticFeedThreads = 4;
+// 日志压测：每个已实例化组件每秒写入的行数
+constexpr int kStressLogLinesPerSecond = 3000;
+constexpr int kStressLogIntervalMs = 16;
+// 布局文件里页号的上限，防止异常文件一次建出大量页面
+constexpr int kMaxPages = 64;
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
@@ -24,21 +66,155 @@ MainWindow::MainWindow(QWidget *parent)
 
     m_container = new FormCanvas;
     m_container->setObjectName("formContainer");
-    m_container->setMinimumSize(1400, 900);
+    m_container->setMinimumSize(kMinCanvasSize);
 
     m_area->setWidget(m_container);
-    setCentralWidget(m_area);
+
+    // 总览：同一份缩略图按窗口大小缩放显示整张画布，点击跳转后回到正常视图
+    m_overview = new MinimapView(m_container);
+    m_centralStack = new QStackedWidget(this);
+    m_centralStack->addWidget(m_area);
+    m_centralStack->addWidget(m_overview);
+
+    // 工作区页签在滚动区域上方；所有页面共用一张画布，切页时换入该页的记录
+    m_pageBar = new QTabBar;
+    m_pageBar->setTabsClosable(true);
+    m_pageBar->setExpanding(false);
+    m_pageBar->setDocumentMode(true);
+    m_pages.append({defaultPageName(0), {}, QPoint()});
+    m_pageBar->addTab(m_pages.first().name);
+    auto *central = new QWidget(this);
+    auto *centralLayout = new QVBoxLayout(central);
+    centralLayout->setContentsMargins(0, 0, 0, 0);
+    centralLayout->setSpacing(0);
+    centralLayout->addWidget(m_pageBar);
+    centralLayout->addWidget(m_centralStack);
+    setCentralWidget(central);
+    connect(m_pageBar, &QTabBar::currentChanged, this, &MainWindow::switchToPage);
+    connect(m_pageBar, &QTabBar::tabCloseRequested, this, &MainWindow::closePage);
+    connect(m_pageBar, &QTabBar::tabBarDoubleClicked, this, &MainWindow::renamePage);
+
+    m_minimap = new MinimapView(m_container);
+    auto *minimapDock = new QDockWidget(tr("缩略图"), this);
+    minimapDock->setObjectName("minimapDock");
+    minimapDock->setWidget(m_minimap);
+    addDockWidget(Qt::RightDockWidgetArea, minimapDock);
+    connect(m_minimap, &MinimapView::jumpRequested, this, &MainWindow::jumpTo);
+    connect(m_overview, &MinimapView::jumpRequested, this, [this](const QPoint &pos) {
+        jumpTo(pos);
+        m_overviewAct->setChecked(false);
+    });
+
+    m_virtualizeTimer = new QTimer(this);
+    m_virtualizeTimer->setSingleShot(true);
+    m_virtualizeTimer->setInterval(0);
+    connect(m_virtualizeTimer, &QTimer::timeout, this, &MainWindow::updateMaterializedForms);
+    connect(m_area->horizontalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::scheduleVirtualization);
+    connect(m_area->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::scheduleVirtualization);
+    connect(m_area->horizontalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateViewportIndicators);
+    connect(m_area->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateViewportIndicators);
+
+    // 流式加载：进度条与取消按钮常驻状态栏，仅在加载中显示
+    m_loader = new LayoutLoader(this);
+    m_loadProgress = new QProgressBar;
+    m_loadProgress->setMaximumWidth(200);
+    m_loadProgress->setRange(0, 1000);
+    m_loadCancel = new QToolButton;
+    m_loadCancel->setText(tr("取消加载"));
+    statusBar()->addPermanentWidget(m_loadProgress);
+    statusBar()->addPermanentWidget(m_loadCancel);
+    m_loadProgress->hide();
+    m_loadCancel->hide();
+    connect(m_loadCancel, &QToolButton::clicked, this, &MainWindow::cancelLayoutLoad);
+    connect(m_loader, &LayoutLoader::recordsParsed, this, &MainWindow::onLayoutRecords);
+    connect(m_loader, &LayoutLoader::pageNameParsed, this, &MainWindow::onLayoutPageName);
+    connect(m_loader, &LayoutLoader::progress, this, [this](qint64 done, qint64 total) {
+        m_loadProgress->setValue(total > 0 ? int(done * 1000 / total) : 0);
+    });
+    connect(m_loader, &LayoutLoader::finished, this, &MainWindow::onLayoutLoaded);
+
+    m_history = new UndoHistory(this);
+
+    m_liveFeed = new LiveFeed(this);
+    connect(m_liveFeed, &LiveFeed::throughput, this, [this](qint64 applied, qint64 dropped) {
+        statusBar()->showMessage(tr("实时数据：%1 条/秒，丢弃 %2 条/秒").arg(applied).arg(dropped), 1500);
+    });
+
+    m_saver = new LayoutSaver(this);
+    connect(m_saver, &LayoutSaver::saved, this, &MainWindow::onLayoutSaved);
 
     auto *tb = addToolBar("Tools");
+    QAction *addPageAct = tb->addAction("新建页面");
     QAction *addAct = tb->addAction("添加组件");
     QAction *addWideAct = tb->addAction("添加宽组件");
+    QAction *freeSpaceAct = tb->addAction("空位放置");
+    freeSpaceAct->setCheckable(true);
+    freeSpaceAct->setChecked(m_placeInFreeSpace);
+    QAction *arrangeAct = tb->addAction("自动排列");
+    QAction *noOverlapAct = tb->addAction("避让模式");
+    noOverlapAct->setCheckable(true);
+    noOverlapAct->setChecked(m_noOverlap);
     tb->addSeparator();
     QAction *saveAct = tb->addAction("保存布局");
     QAction *loadAct = tb->addAction("加载布局");
+    tb->addSeparator();
+    m_undoAct = tb->addAction("撤销");
+    m_undoAct->setShortcut(QKeySequence::Undo);
+    m_redoAct = tb->addAction("重做");
+    m_redoAct->setShortcut(QKeySequence::Redo);
+    tb->addSeparator();
+    QAction *snapshotAct = tb->addAction("快照拖拽");
+    snapshotAct->setCheckable(true);
+    snapshotAct->setChecked(m_snapshotDrag);
+    tb->addSeparator();
+    QAction *profileAct = tb->addAction("性能统计");
+    profileAct->setCheckable(true);
+    QAction *exportProfileAct = tb->addAction("导出统计…");
+    QAction *liveFeedAct = tb->addAction("实时数据");
+    liveFeedAct->setCheckable(true);
+    QAction *logStressAct = tb->addAction("日志压测");
+    logStressAct->setCheckable(true);
+    tb->addSeparator();
+    m_overviewAct = tb->addAction("总览");
+    m_overviewAct->setCheckable(true);
+    tb->addAction(minimapDock->toggleViewAction());
+    tb->addSeparator();
+    auto *alignMenu = new QMenu(this);
+    alignMenu->addAction(tr("左对齐"), this, [this]() { alignSelection(Qt::AlignLeft); });
+    alignMenu->addAction(tr("右对齐"), this, [this]() { alignSelection(Qt::AlignRight); });
+    alignMenu->addAction(tr("顶端对齐"), this, [this]() { alignSelection(Qt::AlignTop); });
+    alignMenu->addAction(tr("底端对齐"), this, [this]() { alignSelection(Qt::AlignBottom); });
+    alignMenu->addAction(tr("水平居中"), this, [this]() { alignSelection(Qt::AlignHCenter); });
+    alignMenu->addAction(tr("垂直居中"), this, [this]() { alignSelection(Qt::AlignVCenter); });
+    alignMenu->addSeparator();
+    m_distributeH = alignMenu->addAction(tr("水平等距分布"), this, [this]() { distributeSelection(Qt::Horizontal); });
+    m_distributeV = alignMenu->addAction(tr("垂直等距分布"), this, [this]() { distributeSelection(Qt::Vertical); });
+    m_alignButton = new QToolButton;
+    m_alignButton->setText(tr("对齐"));
+    m_alignButton->setMenu(alignMenu);
+    m_alignButton->setPopupMode(QToolButton::InstantPopup);
+    tb->addWidget(m_alignButton);
+    connect(m_container, &FormCanvas::selectionChanged, this, &MainWindow::updateSelectionActions);
+    updateSelectionActions();
+
+    connect(addPageAct, &QAction::triggered, this, &MainWindow::addPage);
     connect(addAct, &QAction::triggered, this, &MainWindow::addComponent);
     connect(addWideAct, &QAction::triggered, this, &MainWindow::addWideComponent);
+    connect(freeSpaceAct, &QAction::toggled, this, [this](bool on) { m_placeInFreeSpace = on; });
+    connect(arrangeAct, &QAction::triggered, this, &MainWindow::autoArrange);
+    connect(noOverlapAct, &QAction::toggled, this, [this](bool on) { m_noOverlap = on; });
     connect(saveAct, &QAction::triggered, this, &MainWindow::saveLayout);
     connect(loadAct, &QAction::triggered, this, &MainWindow::loadLayout);
+    connect(m_undoAct, &QAction::triggered, this, &MainWindow::undo);
+    connect(m_redoAct, &QAction::triggered, this, &MainWindow::redo);
+    connect(m_history, &UndoHistory::changed, this, &MainWindow::updateHistoryActions);
+    updateHistoryActions();
+    connect(snapshotAct, &QAction::toggled, this, &MainWindow::setSnapshotDrag);
+    connect(profileAct, &QAction::toggled, this, &MainWindow::setProfilingEnabled);
+    connect(exportProfileAct, &QAction::triggered, this, &MainWindow::exportProfile);
+    connect(m_overviewAct, &QAction::toggled, this, &MainWindow::setOverviewMode);
+    connect(liveFeedAct, &QAction::toggled, this, &MainWindow::setLiveFeedEnabled);
+    connect(logStressAct, &QAction::toggled, this, &MainWindow::setLogStressEnabled);
 
     resize(1280, 800);
 }
@@ -48,147 +224,1102 @@ FormCanvas* MainWindow::container() const
     return m_container;
 }
 
+void MainWindow::resizeEvent(QResizeEvent *event)
+{
+    QMainWindow::resizeEvent(event);
+    scheduleVirtualization();
+    updateViewportIndicators();
+}
+
 void MainWindow::addComponent()
 {
-    createForm(QRect(40 + 20 * m_forms.size(), 40 + 20 * m_forms.size(), 420, 280));
-    maybeExpandContainer();
+    const int n = int(m_records.size());
+    recordCreated(createForm(placeNewForm(QRect(40 + 20 * n, 40 + 20 * n, 420, 280))));
+    updateContainerSize();
 }
 
 void MainWindow::addWideComponent()
 {
-    createForm(QRect(60, 360, 720, 300));
-    maybeExpandContainer();
+    recordCreated(createForm(placeNewForm(QRect(60, 360, 720, 300))));
+    updateContainerSize();
+}
+
+void MainWindow::onFormMoved(const QRect &r)
+{
+    auto *f = qobject_cast<CustomForm*>(sender());
+    if (!f)
+        return;
+    auto it = m_records.find(f->formId());
+    if (it == m_records.end())
+        return;
+    it->geometry = r;
+    trackFormGeometry(f->formId(), r);
+    pushAsideFrom(f->formId(), r);
+    updateContainerSize();
+    scheduleVirtualization();
 }
 
-void MainWindow::onFormMoved(const QRect &)
+void MainWindow::onFormPreviewMoved(const QRect &r)
 {
-    maybeExpandContainer();
+    // 快照拖拽只移动预览，邻居按预览位置推开，避让在拖拽过程中同样可见
+    if (auto *f = qobject_cast<CustomForm*>(sender()))
+        pushAsideFrom(f->formId(), r);
+}
+
+void MainWindow::pushAsideFrom(int id, const QRect &r)
+{
+    // 避让模式：被拖拽的组件每帧把碰到的组件推开，批量落地
+    if (!m_pushAside.isActive() || m_pushAside.draggedId() != id)
+        return;
+    const QHash<int, QRect> geoms = m_pushAside.resolve(r);
+    // 被推开的组件先移出吸附索引再落地，否则拖拽组件会吸回它们身上
+    if (m_pushAside.touchedIds().size() != m_container->snapExcluded().size())
+        m_container->setSnapExcluded(m_pushAside.touchedIds());
+    applyGeometries(geoms);
+}
+
+QHash<int, QRect> MainWindow::finishPushAside()
+{
+    const QHash<int, QRect> origins = m_pushAside.touchedOrigins();
+    m_pushAside.end();
+    m_container->setSnapExcluded(QSet<int>());
+    return origins;
+}
+
+void MainWindow::onDragStarted()
+{
+    auto *f = qobject_cast<CustomForm*>(sender());
+    if (!f)
+        return;
+    m_dragFormId = f->formId();
+    if (m_noOverlap)
+        m_pushAside.begin(m_container->formGrid(), f->formId());
+}
+
+void MainWindow::onDragFinished()
+{
+    m_dragFormId = -1;
+    // 拖拽组件最终没动（未发 geometryCommitted）时，被推开过的组件在这里收尾
+    auto *f = qobject_cast<CustomForm*>(sender());
+    if (!f || !m_pushAside.isActive() || m_pushAside.draggedId() != f->formId())
+        return;
+    commitGeometries(finishPushAside());
 }
 
 void MainWindow::onFormClose(CustomForm *f)
 {
     if (!f) return;
-    m_forms.removeAll(f);
-    f->deleteLater();
-    maybeExpandContainer();
+    const auto it = m_records.constFind(f->formId());
+    if (it == m_records.constEnd())
+        return;
+    // 关闭前留下墓碑，撤销时按原 id 原样恢复
+    UndoHistory::Entry entry;
+    entry.removed.append(currentRecord(*it));
+    removeRecord(it.key());
+    updateContainerSize();
+    m_history->record(std::move(entry));
+}
+
+void MainWindow::removeRecord(int id)
+{
+    if (CustomForm *f = m_widgets.take(id).data())
+        recycleForm(f);
+    m_records.remove(id);
+    m_logs.remove(id);
+    untrackForm(id);
+    if (m_journal)
+        m_journal->recordRemove(id);
+}
+
+void MainWindow::recordCreated(int id)
+{
+    const auto it = m_records.constFind(id);
+    if (it == m_records.constEnd())
+        return;
+    UndoHistory::Entry entry;
+    entry.created.append(*it);
+    m_history->record(std::move(entry));
+}
+
+void MainWindow::undo()
+{
+    if (!m_history->canUndo())
+        return;
+    UndoHistory::Entry entry = m_history->takeUndo();
+    applyHistoryEntry(entry, false);
+    m_history->finishUndo(std::move(entry));
+}
+
+void MainWindow::redo()
+{
+    if (!m_history->canRedo())
+        return;
+    UndoHistory::Entry entry = m_history->takeRedo();
+    applyHistoryEntry(entry, true);
+    m_history->finishRedo(std::move(entry));
+}
+
+void MainWindow::updateHistoryActions()
+{
+    m_undoAct->setEnabled(m_history->canUndo());
+    m_redoAct->setEnabled(m_history->canRedo());
+}
+
+void MainWindow::applyHistoryEntry(UndoHistory::Entry &entry, bool forward)
+{
+    // 只触碰条目里涉及的组件：先删，再按墓碑恢复，最后批量回放几何增量
+    QVector<FormRecord> &toRemove  = forward ? entry.removed : entry.created;
+    QVector<FormRecord> &toRestore = forward ? entry.created : entry.removed;
+
+    for (FormRecord &rec : toRemove) {
+        const auto it = m_records.constFind(rec.id);
+        if (it == m_records.constEnd())
+            continue;
+        rec = currentRecord(*it);
+        removeRecord(rec.id);
+    }
+    for (FormRecord &rec : toRestore) {
+        if (m_records.contains(rec.id))
+            continue;
+        // 历史只属于当前页；墓碑里的页号可能因关闭前面的页面而过期
+        rec.page = m_currentPage;
+        addRecord(rec, true);
+        if (m_journal)
+            m_journal->recordUpsert(rec);
+    }
+
+    QHash<int, QRect> geoms;
+    for (const UndoHistory::GeometryDelta &d : std::as_const(entry.deltas)) {
+        const auto it = m_records.constFind(d.id);
+        if (it != m_records.constEnd())
+            geoms.insert(d.id, UndoHistory::apply(it->geometry, d, forward));
+    }
+    applyGeometries(geoms);
+    if (m_journal) {
+        for (auto it = geoms.cbegin(); it != geoms.cend(); ++it)
+            m_journal->recordUpsert(m_records.value(it.key()));
+    }
+    updateContainerSize();
 }
 
-void MainWindow::maybeExpandContainer()
+void MainWindow::onFormGeometryCommitted(const QRect &from, const QRect &to)
 {
-    int maxRight = 0, maxBottom = 0;
-    // 清除空指针
-    for (auto it = m_forms.begin(); it != m_forms.end(); ) {
-        if (it->isNull()) it = m_forms.erase(it);
-        else ++it;
+    auto *f = qobject_cast<CustomForm*>(sender());
+    if (!f)
+        return;
+    auto it = m_records.find(f->formId());
+    if (it == m_records.end())
+        return;
+    it->geometry = to;
+    // 一次拖拽手势只在松开时记一条，被推开的组件并入同一条
+    QHash<int, QRect> before;
+    if (m_pushAside.isActive() && m_pushAside.draggedId() == it.key()) {
+        before = finishPushAside();
     }
-    for (const auto &pf : m_forms) {
-        if (auto *w = pf.data()) {
-            QRect g = w->geometry();
-            maxRight  = std::max(maxRight,  g.right());
-            maxBottom = std::max(maxBottom, g.bottom());
+    before.insert(it.key(), from);
+    commitGeometries(before);
+}
+
+void MainWindow::onGroupDragStarted()
+{
+    if (auto *f = qobject_cast<CustomForm*>(sender()))
+        m_dragFormId = f->formId();
+    m_groupDragOrigin = selectedGeometries();
+    m_container->setSnapExcluded(m_container->selection());
+}
+
+void MainWindow::onGroupDragMoved(const QPoint &delta)
+{
+    QHash<int, QRect> geoms;
+    geoms.reserve(m_groupDragOrigin.size());
+    for (auto it = m_groupDragOrigin.cbegin(); it != m_groupDragOrigin.cend(); ++it)
+        geoms.insert(it.key(), it.value().translated(delta));
+    applyGeometries(geoms);
+}
+
+void MainWindow::onGroupDragFinished()
+{
+    m_dragFormId = -1;
+    m_container->setSnapExcluded(QSet<int>());
+    commitGeometries(m_groupDragOrigin);
+    m_groupDragOrigin.clear();
+}
+
+void MainWindow::updateSelectionActions()
+{
+    const int n = int(m_container->selection().size());
+    m_alignButton->setEnabled(n >= 2);
+    m_distributeH->setEnabled(n >= 3);
+    m_distributeV->setEnabled(n >= 3);
+}
+
+QHash<int, QRect> MainWindow::selectedGeometries() const
+{
+    QHash<int, QRect> geoms;
+    for (int id : m_container->selection()) {
+        const auto it = m_records.constFind(id);
+        if (it != m_records.constEnd())
+            geoms.insert(id, it->geometry);
+    }
+    return geoms;
+}
+
+void MainWindow::applyGeometries(const QHash<int, QRect> &geoms)
+{
+    if (geoms.isEmpty())
+        return;
+    // 不用 setUpdatesEnabled 暂停画布：恢复时会整块重绘，抵消脏区绘制。本轮的 update 本来就
+    // 合并到下一次绘制，这里只收集新旧矩形的外接矩形，循环后统一 update 一次；
+    // 组件的 moved 信号被屏蔽，不逐个回调
+    QRect dirty;
+    for (auto it = geoms.cbegin(); it != geoms.cend(); ++it) {
+        auto rec = m_records.find(it.key());
+        if (rec == m_records.end() || rec->geometry == it.value())
+            continue;
+        dirty = dirty.united(rec->geometry).united(it.value());
+        rec->geometry = it.value();
+        trackFormGeometry(it.key(), it.value());
+        if (CustomForm *f = m_widgets.value(it.key()).data()) {
+            const QSignalBlocker blocker(f);
+            f->setGeometry(it.value());
+        } else {
+            m_container->setPlaceholder(it.key(), it.value());
+        }
+    }
+    if (dirty.isEmpty())
+        return;
+    m_container->update(dirty);
+    updateContainerSize();
+    scheduleVirtualization();
+}
+
+void MainWindow::commitGeometries(const QHash<int, QRect> &before)
+{
+    // 事务结束：变化了的组件写日志，并合成一条撤销记录
+    UndoHistory::Entry entry;
+    for (auto it = before.cbegin(); it != before.cend(); ++it) {
+        const auto rec = m_records.constFind(it.key());
+        if (rec == m_records.constEnd() || rec->geometry == it.value())
+            continue;
+        entry.deltas.append(UndoHistory::delta(it.key(), it.value(), rec->geometry));
+        if (m_journal)
+            m_journal->recordUpsert(*rec);
+    }
+    m_history->record(std::move(entry));
+}
+
+QRect MainWindow::placeNewForm(const QRect &preferred) const
+{
+    if (!m_placeInFreeSpace)
+        return preferred;
+
+    // 先在当前视口里找空位，找不到再放到全部组件的下方
+    const int grid = m_container->gridSize();
+    const QRect visible = visibleCanvasRect().adjusted(grid, grid, -grid, -grid);
+    QPoint pos;
+    if (findFreeSpot(m_container->formGrid(), preferred.size(), visible, grid, grid, &pos))
+        return QRect(pos, preferred.size());
+    const int below = m_extents.maxBottom() + 2 * grid;
+    return QRect(QPoint(grid, below - below % grid), preferred.size());
+}
+
+void MainWindow::autoArrange()
+{
+    // 选中多个时只排列选中的（从其外接矩形左上角开始），否则排列全部
+    QHash<int, QRect> before = selectedGeometries();
+    const bool selectionOnly = before.size() >= 2;
+    if (!selectionOnly) {
+        before.clear();
+        for (const FormRecord &rec : std::as_const(m_records))
+            before.insert(rec.id, rec.geometry);
+    }
+    if (before.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int grid = m_container->gridSize();
+    const QSize minSize(CustomForm::MinimumWidth, CustomForm::MinimumHeight);
+    QVector<int> ids = before.keys();
+    std::sort(ids.begin(), ids.end());
+    QVector<QSize> sizes;
+    sizes.reserve(ids.size());
+    QRect bounds;
+    int widest = 0;
+    for (int id : std::as_const(ids)) {
+        const QRect r = before.value(id);
+        sizes.append(r.size().expandedTo(minSize));
+        bounds = bounds.united(r);
+        widest = std::max(widest, sizes.last().width());
+    }
+
+    QPoint origin(grid, grid);
+    int width = m_area->viewport()->width() - 2 * grid;
+    if (selectionOnly) {
+        origin = QPoint(bounds.left() - bounds.left() % grid, bounds.top() - bounds.top() % grid);
+        width = bounds.width();
+    }
+    width = std::max(width, widest + grid);
+
+    const QVector<QRect> packed = SkylinePacker::pack(sizes, origin, width, grid, grid);
+    QHash<int, QRect> geoms;
+    geoms.reserve(ids.size());
+    for (int i = 0; i < ids.size(); ++i)
+        geoms.insert(ids.at(i), packed.at(i));
+    const qint64 packMs = timer.elapsed();
+
+    applyGeometries(geoms);
+    commitGeometries(before);
+    statusBar()->showMessage(tr("已排列 %1 个组件，装箱 %2 ms，共 %3 ms")
+                             .arg(ids.size()).arg(packMs).arg(timer.elapsed()), 5000);
+}
+
+void MainWindow::alignSelection(Qt::AlignmentFlag edge)
+{
+    const QHash<int, QRect> before = selectedGeometries();
+    if (before.size() < 2)
+        return;
+    QRect bounds;
+    for (const QRect &r : before)
+        bounds = bounds.united(r);
+
+    QHash<int, QRect> geoms;
+    for (auto it = before.cbegin(); it != before.cend(); ++it) {
+        QRect r = it.value();
+        switch (edge) {
+        case Qt::AlignLeft:    r.moveLeft(bounds.left()); break;
+        case Qt::AlignRight:   r.moveRight(bounds.right()); break;
+        case Qt::AlignTop:     r.moveTop(bounds.top()); break;
+        case Qt::AlignBottom:  r.moveBottom(bounds.bottom()); break;
+        case Qt::AlignHCenter: r.moveLeft(bounds.center().x() - r.width() / 2); break;
+        case Qt::AlignVCenter: r.moveTop(bounds.center().y() - r.height() / 2); break;
+        default: break;
         }
+        geoms.insert(it.key(), r);
     }
-    // 留边距
-    maxRight  += 40;
-    maxBottom += 40;
+    applyGeometries(geoms);
+    commitGeometries(before);
+}
+
+void MainWindow::distributeSelection(Qt::Orientation orientation)
+{
+    const QHash<int, QRect> before = selectedGeometries();
+    if (before.size() < 3)
+        return;
+
+    // 首尾不动，中间的按顺序排开，使相邻间距相等
+    const bool horizontal = orientation == Qt::Horizontal;
+    QVector<int> ids = before.keys();
+    auto start = [&](int id) { return horizontal ? before.value(id).left() : before.value(id).top(); };
+    auto extent = [&](int id) { return horizontal ? before.value(id).width() : before.value(id).height(); };
+    std::sort(ids.begin(), ids.end(), [&](int a, int b) { return start(a) < start(b); });
 
-    const int needW = std::max(maxRight,  m_container->minimumWidth());
-    const int needH = std::max(maxBottom, m_container->minimumHeight());
+    const int first = start(ids.first());
+    const int last = start(ids.last()) + extent(ids.last());
+    int total = 0;
+    for (int id : std::as_const(ids))
+        total += extent(id);
+    const double gap = double(last - first - total) / (ids.size() - 1);
+
+    QHash<int, QRect> geoms;
+    double pos = first;
+    for (int id : std::as_const(ids)) {
+        QRect r = before.value(id);
+        if (horizontal)
+            r.moveLeft(qRound(pos));
+        else
+            r.moveTop(qRound(pos));
+        geoms.insert(id, r);
+        pos += extent(id) + gap;
+    }
+    applyGeometries(geoms);
+    commitGeometries(before);
+}
+
+void MainWindow::enableAutosave(const QString &dir)
+{
+    if (m_journal)
+        return;
+    auto *journal = new LayoutJournal(dir, this);
+
+    // 恢复上次会话：先建页面（含空白页），再放记录，记录保留原 id。
+    // 重放完才挂上 m_journal，重放期间不再写日志
+    const LayoutDocument restored = journal->replay();
+    for (int i = 0; i < restored.pageNames.size(); ++i)
+        onLayoutPageName(i, restored.pageNames.at(i));
+    for (FormRecord rec : restored.records) {
+        rec.page = std::clamp(rec.page, 0, kMaxPages - 1);
+        addRecordToPage(rec, false);
+        m_nextFormId = std::max(m_nextFormId, rec.id + 1);
+    }
+    updateContainerSize();
+
+    m_journal = journal;
+    m_journal->setSnapshotProvider([this]() { return LayoutDocument{workspaceRecords(), workspacePageNames()}; });
+}
+
+void MainWindow::setSnapshotDrag(bool on)
+{
+    m_snapshotDrag = on;
+    const auto mode = on ? CustomForm::SnapshotDrag : CustomForm::LiveDrag;
+    for (const auto &pf : std::as_const(m_widgets)) {
+        if (auto *w = pf.data())
+            w->setDragRenderMode(mode);
+    }
+}
+
+void MainWindow::setProfilingEnabled(bool on)
+{
+    // 每次打开都从空样本开始，浮层只反映本次开启以来的数据
+    if (on)
+        FrameProfiler::instance().reset();
+    FrameProfiler::setEnabled(on);
+    m_container->setProfilerHudVisible(on);
+}
+
+void MainWindow::exportProfile()
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("导出性能统计"), QString(),
+                                                          tr("CSV 文件 (*.csv)"));
+    if (fileName.isEmpty())
+        return;
+    QString error;
+    if (!FrameProfiler::instance().exportCsv(fileName, &error))
+        QMessageBox::warning(this, tr("导出失败"), error);
+}
+
+void MainWindow::updateContainerSize()
+{
+    // 按最外侧组件留边距，可增可减，但不小于初始尺寸
+    ProfileScope scope(FrameProfiler::ContainerResize);
+    const int needW = std::max(m_extents.maxRight()  + kCanvasMargin, kMinCanvasSize.width());
+    const int needH = std::max(m_extents.maxBottom() + kCanvasMargin, kMinCanvasSize.height());
     if (needW != m_container->minimumWidth() || needH != m_container->minimumHeight())
         m_container->setMinimumSize(needW, needH);
 }
 
-CustomForm* MainWindow::createForm(const QRect &geom)
+void MainWindow::trackFormGeometry(int id, const QRect &geom)
+{
+    m_container->setFormGeometry(id, geom);
+    m_extents.insert(id, geom);
+}
+
+void MainWindow::untrackForm(int id)
+{
+    m_container->removeForm(id);
+    m_extents.remove(id);
+}
+
+int MainWindow::createForm(const QRect &geom, const QJsonObject &state, bool materializeNow, int page)
+{
+    FormRecord rec;
+    rec.id = m_nextFormId++;
+    rec.page = page < 0 ? m_currentPage : std::min(page, kMaxPages - 1);
+    rec.geometry = QRect(geom.topLeft(),
+                         geom.size().expandedTo(QSize(CustomForm::MinimumWidth, CustomForm::MinimumHeight)));
+    rec.state = state;
+    addRecordToPage(rec, materializeNow);
+    if (m_journal)
+        m_journal->recordUpsert(rec);
+    return rec.id;
+}
+
+void MainWindow::addRecord(const FormRecord &rec, bool materializeNow)
+{
+    m_records.insert(rec.id, rec);
+    trackFormGeometry(rec.id, rec.geometry);
+
+    // 视口附近的直接实例化，其余先画占位
+    const QRect nearby = visibleCanvasRect().adjusted(-kMaterializeMargin, -kMaterializeMargin,
+                                                    kMaterializeMargin, kMaterializeMargin);
+    if (materializeNow && rec.geometry.intersects(nearby)) {
+        materializeForm(rec.id);
+    } else {
+        m_container->setPlaceholder(rec.id, rec.geometry);
+        if (!materializeNow)
+            scheduleVirtualization();
+    }
+}
+
+void MainWindow::addRecordToPage(const FormRecord &rec, bool materializeNow)
+{
+    if (rec.page == m_currentPage) {
+        addRecord(rec, materializeNow);
+        return;
+    }
+    ensurePage(rec.page);
+    m_pages[rec.page].records.append(rec);
+}
+
+CustomForm* MainWindow::materializeForm(int id)
 {
-    auto *f = new CustomForm(container());
-    f->setGeometry(geom);
+    if (auto *existing = m_widgets.value(id).data())
+        return existing;
+    const auto it = m_records.constFind(id);
+    if (it == m_records.constEnd())
+        return nullptr;
+
+    CustomForm *f = acquireForm();
+    f->setFormId(id);
+    f->setDragRenderMode(m_snapshotDrag ? CustomForm::SnapshotDrag : CustomForm::LiveDrag);
+    f->setGeometry(it->geometry);
+    f->setLogBuffer(logBuffer(id));
+    f->restoreState(it->state);
+    subscribeSyntheticFeed(id, f);
+    m_container->removePlaceholder(id);
     f->show();
 
     connect(f, &CustomForm::moved, this, &MainWindow::onFormMoved);
+    connect(f, &CustomForm::previewMoved, this, &MainWindow::onFormPreviewMoved);
     connect(f, &CustomForm::requestClose, this, &MainWindow::onFormClose);
+    connect(f, &CustomForm::geometryCommitted, this, &MainWindow::onFormGeometryCommitted);
+    connect(f, &CustomForm::dragStarted, this, &MainWindow::onDragStarted);
+    connect(f, &CustomForm::dragFinished, this, &MainWindow::onDragFinished);
+    connect(f, &CustomForm::groupDragStarted, this, &MainWindow::onGroupDragStarted);
+    connect(f, &CustomForm::groupDragMoved, this, &MainWindow::onGroupDragMoved);
+    connect(f, &CustomForm::groupDragFinished, this, &MainWindow::onGroupDragFinished);
 
-    m_forms << QPointer<CustomForm>(f);
+    m_widgets.insert(id, QPointer<CustomForm>(f));
+    m_container->attachForm(id, f);
     return f;
 }
 
-QJsonArray MainWindow::serializeForms() const
+void MainWindow::releaseForm(int id)
+{
+    CustomForm *f = m_widgets.take(id).data();
+    if (!f)
+        return;
+    auto it = m_records.find(id);
+    if (it != m_records.end()) {
+        it->geometry = f->geometry();
+        it->state = formState(id, f);
+        m_container->setPlaceholder(id, it->geometry);
+    }
+    recycleForm(f);
+}
+
+QSharedPointer<LogBuffer> MainWindow::logBuffer(int id)
+{
+    // 按需建立；槽位在第一次写入时才分配，没写过日志的组件几乎不占内存
+    QSharedPointer<LogBuffer> &buffer = m_logs[id];
+    if (!buffer)
+        buffer = QSharedPointer<LogBuffer>::create();
+    return buffer;
+}
+
+void MainWindow::warmUpFormPool(int count)
+{
+    count = std::min(count, kMaxPooledForms);
+    while (m_formPool.size() < count) {
+        auto *f = new CustomForm(container());
+        f->hide();
+        m_formPool.append(f);
+    }
+}
+
+CustomForm* MainWindow::acquireForm()
+{
+    if (!m_formPool.isEmpty())
+        return m_formPool.takeLast();
+    return new CustomForm(container());
+}
+
+void MainWindow::recycleForm(CustomForm *f)
+{
+    m_syntheticFeeds.remove(f->formId());
+    m_container->detachForm(f->formId());
+    f->disconnect(this);
+    f->hide();
+    if (m_formPool.size() >= kMaxPooledForms) {
+        f->deleteLater();
+        return;
+    }
+    f->resetForReuse();
+    m_formPool.append(f);
+}
+
+void MainWindow::scheduleVirtualization()
+{
+    if (!m_virtualizeTimer->isActive())
+        m_virtualizeTimer->start();
+}
+
+QRect MainWindow::visibleCanvasRect() const
 {
-    QJsonArray arr;
-    for (const auto &pf : m_forms) {
-        if (auto *w = pf.data()) {
-            const QRect g = w->geometry();
-            QJsonObject obj;
-            obj["x"] = g.x();
-            obj["y"] = g.y();
-            obj["w"] = g.width();
-            obj["h"] = g.height();
-            arr.append(obj);
+    // 容器是滚动区域的内容部件，其位置即滚动偏移的相反数
+    return QRect(-m_container->pos(), m_area->viewport()->size());
+}
+
+void MainWindow::updateViewportIndicators()
+{
+    const QRect visible = visibleCanvasRect();
+    m_minimap->setViewportRect(visible);
+    m_overview->setViewportRect(visible);
+}
+
+void MainWindow::jumpTo(const QPoint &canvasPos)
+{
+    const QSize view = m_area->viewport()->size();
+    m_area->horizontalScrollBar()->setValue(canvasPos.x() - view.width() / 2);
+    m_area->verticalScrollBar()->setValue(canvasPos.y() - view.height() / 2);
+}
+
+void MainWindow::setLiveFeedEnabled(bool on)
+{
+    m_syntheticFeed = on;
+    if (!on) {
+        m_liveFeed->stopSynthetic();
+        m_liveFeed->stop();
+        // 压测订阅不进记录，关掉时把仍在看合成数据源的组件恢复为示例数据
+        const auto subscribed = m_syntheticFeeds;
+        m_syntheticFeeds.clear();
+        for (auto it = subscribed.cbegin(); it != subscribed.cend(); ++it) {
+            CustomForm *w = m_widgets.value(it.key()).data();
+            if (w && w->datasetPath() == it.value())
+                w->openDataset(QString());
         }
+        return;
     }
-    return arr;
+    // 尚未指定数据集的已实例化组件按 id 分摊订阅各数据源；其余的在实例化时订阅
+    for (auto it = m_widgets.cbegin(); it != m_widgets.cend(); ++it) {
+        if (CustomForm *w = it.value().data())
+            subscribeSyntheticFeed(it.key(), w);
+    }
+    m_liveFeed->startSynthetic(kSyntheticFeedRate, kSyntheticFeedThreads);
 }
 
-void MainWindow::recreateFromJson(const QJsonArray &arr)
+void MainWindow::subscribeSyntheticFeed(int id, CustomForm *f)
 {
-    for (const auto &pf : m_forms) {
-        if (auto *w = pf.data())
-            w->deleteLater();
+    if (!m_syntheticFeed || !f->datasetPath().isEmpty())
+        return;
+    const QString key = LiveFeed::feedKey(id % LiveFeed::kFeedCount);
+    if (f->openDataset(key))
+        m_syntheticFeeds.insert(id, key);
+}
+
+QJsonObject MainWindow::formState(int id, const CustomForm *f) const
+{
+    // 压测期间的合成订阅是临时的，不写进记录、日志与布局文件
+    QJsonObject state = f->saveState();
+    const auto it = m_syntheticFeeds.constFind(id);
+    if (it != m_syntheticFeeds.constEnd() && state.value("dataset").toString() == it.value())
+        state.remove("dataset");
+    return state;
+}
+
+void MainWindow::setLogStressEnabled(bool on)
+{
+    if (!m_logStressTimer) {
+        m_logStressTimer = new QTimer(this);
+        m_logStressTimer->setInterval(kStressLogIntervalMs);
+        connect(m_logStressTimer, &QTimer::timeout, this, &MainWindow::emitStressLogLines);
+    }
+    if (on)
+        m_logStressTimer->start();
+    else
+        m_logStressTimer->stop();
+}
+
+void MainWindow::emitStressLogLines()
+{
+    // 只写已实例化的组件；日志按 id 保存在 m_logs，组件回收后仍在，但不进记录
+    const int perTick = kStressLogLinesPerSecond * kStressLogIntervalMs / 1000;
+    const QString stamp = QTime::currentTime().toString(QStringLiteral("HH:mm:ss.zzz"));
+    for (auto it = m_widgets.cbegin(); it != m_widgets.cend(); ++it) {
+        CustomForm *f = it.value().data();
+        if (!f)
+            continue;
+        for (int i = 0; i < perTick; ++i) {
+            f->appendLog(QStringLiteral("%1 [form %2] seq=%3 value=%4")
+                         .arg(stamp).arg(it.key()).arg(m_logStressSeq).arg(m_logStressSeq % 997));
+            ++m_logStressSeq;
+        }
+    }
+}
+
+void MainWindow::setOverviewMode(bool on)
+{
+    m_centralStack->setCurrentWidget(on ? static_cast<QWidget*>(m_overview) : m_area);
+}
+
+void MainWindow::updateMaterializedForms()
+{
+    const QRect visible = visibleCanvasRect();
+    const QRect keep = visible.adjusted(-kReleaseMargin, -kReleaseMargin, kReleaseMargin, kReleaseMargin);
+    const QRect nearby = visible.adjusted(-kMaterializeMargin, -kMaterializeMargin,
+                                        kMaterializeMargin, kMaterializeMargin);
+
+    // 释放远离视口的组件（正在拖拽的除外：按下时的隐式鼠标抓取不经 mouseGrabber() 报告，按 id 判断）
+    QVector<int> far;
+    for (auto it = m_widgets.cbegin(); it != m_widgets.cend(); ++it) {
+        CustomForm *f = it.value().data();
+        if (!f || (!f->geometry().intersects(keep) && it.key() != m_dragFormId))
+            far.append(it.key());
+    }
+    for (int id : std::as_const(far))
+        releaseForm(id);
+
+    QVector<int> pending;
+    const SpatialGrid &grid = m_container->formGrid();
+    for (int id : grid.query(nearby)) {
+        if (!m_widgets.contains(id))
+            pending.append(id);
     }
-    m_forms.clear();
+    if (pending.isEmpty())
+        return;
+
+    const QPoint center = visible.center();
+    auto distance = [&](int id) {
+        return (grid.rect(id).center() - center).manhattanLength();
+    };
+    std::sort(pending.begin(), pending.end(), [&](int a, int b) { return distance(a) < distance(b); });
+
+    QElapsedTimer budget;
+    budget.start();
+    for (int id : std::as_const(pending)) {
+        if (budget.elapsed() >= kMaterializeBudgetMs) {
+            // 剩余的下一轮继续，先让出事件循环
+            scheduleVirtualization();
+            break;
+        }
+        materializeForm(id);
+    }
+}
+
+QVector<FormRecord> MainWindow::snapshotRecords() const
+{
+    QVector<FormRecord> records;
+    records.reserve(m_records.size());
+    for (const FormRecord &rec : m_records)
+        records.append(currentRecord(rec));
+    return records;
+}
+
+QVector<FormRecord> MainWindow::workspaceRecords() const
+{
+    QVector<FormRecord> records;
+    for (int i = 0; i < m_pages.size(); ++i) {
+        if (i == m_currentPage)
+            records += snapshotRecords();
+        else
+            records += m_pages.at(i).records;
+    }
+    return records;
+}
+
+QStringList MainWindow::workspacePageNames() const
+{
+    // 只有一页且未改名时不写页面名称，与单页布局文件保持一致
+    QStringList names;
+    if (m_pages.size() == 1 && m_pages.first().name == defaultPageName(0))
+        return names;
+    for (const WorkspacePage &page : m_pages)
+        names.append(page.name);
+    return names;
+}
+
+FormRecord MainWindow::currentRecord(const FormRecord &rec) const
+{
+    // 已实例化的组件以界面上的几何与状态为准
+    FormRecord current = rec;
+    if (auto *w = m_widgets.value(rec.id).data()) {
+        current.geometry = w->geometry();
+        current.state = formState(rec.id, w);
+    }
+    return current;
+}
+
+void MainWindow::recreateFromJson(const QJsonArray &arr)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    clearForms();
 
     for (const QJsonValue &value : arr) {
         if (!value.isObject())
             continue;
-        const QJsonObject obj = value.toObject();
-        const int x = obj.value("x").toInt();
-        const int y = obj.value("y").toInt();
-        const int w = obj.value("w").toInt(420);
-        const int h = obj.value("h").toInt(280);
-        createForm(QRect(x, y, std::max(w, 1), std::max(h, 1)));
+        const FormRecord rec = formRecordFromJson(value.toObject());
+        createForm(rec.geometry, rec.state, true, rec.page);
     }
 
-    maybeExpandContainer();
+    updateContainerSize();
+    statusBar()->showMessage(tr("已加载 %1 个组件，用时 %2 ms").arg(m_records.size()).arg(timer.elapsed()), 5000);
 }
 
-void MainWindow::saveLayout()
+void MainWindow::clearForms()
 {
-    const QString fileName = QFileDialog::getSaveFileName(this, tr("保存布局"), QString(), tr("布局文件 (*.json)"));
-    if (fileName.isEmpty())
+    unloadForms();
+    m_history->clear();
+    m_logs.clear();
+    m_pages.resize(1);
+    m_pages.first() = {defaultPageName(0), {}, QPoint()};
+    m_currentPage = 0;
+    {
+        QSignalBlocker blocker(m_pageBar);
+        while (m_pageBar->count() > 1)
+            m_pageBar->removeTab(m_pageBar->count() - 1);
+        m_pageBar->setTabText(0, m_pages.first().name);
+        m_pageBar->setCurrentIndex(0);
+    }
+    if (m_journal)
+        m_journal->recordClear();
+}
+
+void MainWindow::unloadForms()
+{
+    // 现有组件全部回收进对象池，重建时直接复用
+    const auto widgets = m_widgets;
+    m_widgets.clear();
+    for (const auto &pf : widgets) {
+        if (auto *w = pf.data())
+            recycleForm(w);
+    }
+    m_records.clear();
+    m_container->clearForms();
+    m_extents.clear();
+    m_groupDragOrigin.clear();
+    m_dragFormId = -1;
+    m_pushAside.end();
+}
+
+QString MainWindow::defaultPageName(int index)
+{
+    return tr("页面 %1").arg(index + 1);
+}
+
+void MainWindow::ensurePage(int index)
+{
+    if (index < m_pages.size())
         return;
+    {
+        QSignalBlocker blocker(m_pageBar);
+        while (m_pages.size() <= index) {
+            m_pages.append({defaultPageName(int(m_pages.size())), {}, QPoint()});
+            m_pageBar->addTab(m_pages.last().name);
+        }
+    }
+    journalPages();
+}
+
+void MainWindow::journalPages()
+{
+    // 页面列表单独记一条，空白页和页面名称在重放时才能还原
+    if (m_journal)
+        m_journal->recordPages(workspacePageNames());
+}
 
-    const QJsonArray arr = serializeForms();
-    QJsonDocument doc(arr);
+void MainWindow::addPage()
+{
+    if (m_pages.size() >= kMaxPages)
+        return;
+    ensurePage(int(m_pages.size()));
+    switchToPage(int(m_pages.size()) - 1);
+}
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::warning(this, tr("保存失败"), tr("无法写入文件：%1").arg(file.errorString()));
+void MainWindow::switchToPage(int index)
+{
+    if (index < 0 || index >= m_pages.size() || index == m_currentPage)
         return;
+    // 正在流式加载的记录属于当前页，切走前先停下
+    cancelLayoutLoad();
+    hibernateCurrentPage();
+    activatePage(index);
+}
+
+void MainWindow::hibernateCurrentPage()
+{
+    // 休眠：只留记录、滚动位置与撤销历史，组件回收进对象池，画布上的索引与占位全部清掉
+    WorkspacePage &page = m_pages[m_currentPage];
+    page.records = snapshotRecords();
+    page.scroll = QPoint(m_area->horizontalScrollBar()->value(), m_area->verticalScrollBar()->value());
+    page.history = m_history->takeState();
+    unloadForms();
+}
+
+void MainWindow::activatePage(int index)
+{
+    m_currentPage = index;
+    {
+        QSignalBlocker blocker(m_pageBar);
+        m_pageBar->setCurrentIndex(index);
     }
 
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    // 先只建记录与占位，视口附近的组件由分时的虚拟化过程重建
+    WorkspacePage &page = m_pages[index];
+    const QVector<FormRecord> records = std::move(page.records);
+    page.records = QVector<FormRecord>();
+    for (const FormRecord &rec : records)
+        addRecord(rec, false);
+    m_history->restoreState(std::move(page.history));
+    page.history = UndoHistory::State();
+    updateContainerSize();
+
+    // 容器尺寸在下一轮布局后才生效，恢复滚动位置后再实例化，避免先在左上角建一批
+    m_virtualizeTimer->stop();
+    const QPoint scroll = page.scroll;
+    QTimer::singleShot(0, this, [this, index, scroll]() {
+        if (m_currentPage != index)
+            return;
+        m_area->horizontalScrollBar()->setValue(scroll.x());
+        m_area->verticalScrollBar()->setValue(scroll.y());
+        scheduleVirtualization();
+        updateViewportIndicators();
+    });
+    statusBar()->showMessage(tr("%1：%2 个组件").arg(page.name).arg(records.size()), 3000);
 }
 
-void MainWindow::loadLayout()
+void MainWindow::closePage(int index)
 {
-    const QString fileName = QFileDialog::getOpenFileName(this, tr("加载布局"), QString(), tr("布局文件 (*.json)"));
+    if (m_pages.size() <= 1 || index < 0 || index >= m_pages.size())
+        return;
+    const int count = index == m_currentPage ? int(m_records.size()) : int(m_pages.at(index).records.size());
+    if (count > 0 && QMessageBox::question(this, tr("关闭页面"),
+                                           tr("页面“%1”中的 %2 个组件将被删除，且无法撤销。是否继续？")
+                                           .arg(m_pages.at(index).name).arg(count)) != QMessageBox::Yes)
+        return;
+
+    if (index == m_currentPage)
+        switchToPage(index > 0 ? index - 1 : index + 1);
+    for (const FormRecord &rec : std::as_const(m_pages.at(index).records)) {
+        m_logs.remove(rec.id);
+        if (m_journal)
+            m_journal->recordRemove(rec.id);
+    }
+    m_pages.remove(index);
+    if (m_currentPage > index)
+        --m_currentPage;
+    {
+        QSignalBlocker blocker(m_pageBar);
+        m_pageBar->removeTab(index);
+        m_pageBar->setCurrentIndex(m_currentPage);
+    }
+    journalPages();
+
+    // 后面的页面序号前移，记录里的页号随之更新
+    for (int i = index; i < m_pages.size(); ++i) {
+        if (i == m_currentPage) {
+            for (FormRecord &rec : m_records) {
+                rec.page = i;
+                if (m_journal)
+                    m_journal->recordUpsert(currentRecord(rec));
+            }
+            continue;
+        }
+        for (FormRecord &rec : m_pages[i].records) {
+            rec.page = i;
+            if (m_journal)
+                m_journal->recordUpsert(rec);
+        }
+    }
+}
+
+void MainWindow::renamePage(int index)
+{
+    if (index < 0) {
+        addPage();
+        return;
+    }
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("重命名页面"), tr("页面名称："), QLineEdit::Normal,
+                                               m_pages.at(index).name, &ok).trimmed();
+    if (!ok || name.isEmpty())
+        return;
+    setPageName(index, name);
+}
+
+void MainWindow::setPageName(int index, const QString &name)
+{
+    ensurePage(index);
+    m_pages[index].name = name;
+    m_pageBar->setTabText(index, name);
+    journalPages();
+}
+
+void MainWindow::saveLayout()
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("保存布局"), QString(),
+                                                          tr("JSON 布局 (*.json);;二进制布局 (*.tlay)"));
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(this, tr("加载失败"), tr("无法读取文件：%1").arg(file.errorString()));
+    // GUI 线程只取快照，写盘在后台完成；全部页面写进同一个文件
+    m_saver->save(fileName, {workspaceRecords(), workspacePageNames()});
+    statusBar()->showMessage(tr("正在保存布局…"));
+}
+
+void MainWindow::onLayoutSaved(const QString &fileName, bool ok, const QString &error)
+{
+    if (!ok) {
+        statusBar()->clearMessage();
+        QMessageBox::warning(this, tr("保存失败"), tr("无法写入文件：%1").arg(error));
         return;
     }
+    statusBar()->showMessage(tr("布局已保存：%1").arg(fileName), 5000);
+}
 
-    const QByteArray data = file.readAll();
-    file.close();
+void MainWindow::loadLayout()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("加载布局"), QString(), tr("布局文件 (*.json *.tlay)"));
+    if (fileName.isEmpty())
+        return;
+    if (!loadLayoutFile(fileName))
+        QMessageBox::warning(this, tr("加载失败"), tr("无法读取文件：%1").arg(m_loader->errorString()));
+}
+
+bool MainWindow::loadLayoutFile(const QString &fileName)
+{
+    m_loader->cancel();
+    if (!m_loader->start(fileName))
+        return false;
+
+    clearForms();
+    updateContainerSize();
+    m_loadTimer.start();
+    m_loadProgress->setValue(0);
+    m_loadProgress->show();
+    m_loadCancel->show();
+    return true;
+}
+
+void MainWindow::onLayoutRecords(const QVector<FormRecord> &records)
+{
+    // 先只建记录与占位，组件实例化交给分时的虚拟化过程按离视口远近进行；
+    // 其他页面的记录直接进休眠页
+    for (const FormRecord &rec : records)
+        createForm(rec.geometry, rec.state, false, std::min(rec.page, kMaxPages - 1));
+    updateContainerSize();
+}
+
+void MainWindow::onLayoutPageName(int page, const QString &name)
+{
+    // 名称为空的页面仍要建出来（可能是空白页），只是沿用默认名称
+    if (page >= kMaxPages)
+        return;
+    if (name.isEmpty())
+        ensurePage(page);
+    else
+        setPageName(page, name);
+}
 
-    const QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isArray()) {
-        QMessageBox::warning(this, tr("加载失败"), tr("文件格式不正确"));
+void MainWindow::onLayoutLoaded(bool ok)
+{
+    m_loadProgress->hide();
+    m_loadCancel->hide();
+    if (!ok) {
+        QMessageBox::warning(this, tr("加载失败"), m_loader->errorString());
         return;
     }
+    statusBar()->showMessage(tr("已加载 %1 个组件，用时 %2 ms").arg(m_records.size()).arg(m_loadTimer.elapsed()), 5000);
+}
 
-    recreateFromJson(doc.array());
-}
\ No newline at end of file
+void MainWindow::cancelLayoutLoad()
+{
+    if (!m_loader->isRunning())
+        return;
+    m_loader->cancel();
+    m_loadProgress->hide();
+    m_loadCancel->hide();
+    statusBar()->showMessage(tr("已取消加载，保留已读取的 %1 个组件").arg(m_records.size()), 5000);
+}
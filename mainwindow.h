@@ -1,38 +1,198 @@
 #pragma once
 #include <QMainWindow>
 #include <QPointer>
-#include <QList>
+#include <QSharedPointer>
+#include <QHash>
+#include <QMap>
+#include <QVector>
 #include <QJsonArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QPoint>
+#include <QStringList>
+
+#include "canvasextents.h"
+#include "formrecord.h"
+#include "undohistory.h"
+#include "pushaside.h"
 
 class QScrollArea;
 class QWidget;
+class QTimer;
+class QProgressBar;
+class QToolButton;
+class QAction;
+class LayoutLoader;
+class LayoutSaver;
+class LayoutJournal;
 class CustomForm;
 class FormCanvas;
+class LiveFeed;
+class LogBuffer;
+class MinimapView;
+class QStackedWidget;
+class QTabBar;
+
+class FormBenchmark;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
+    friend class FormBenchmark;     // 基准程序直接驱动内部热点路径
 public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override = default;
 
+    // 预先构造若干隐藏的 CustomForm 放入对象池
+    void warmUpFormPool(int count);
+
+    // 打开自动保存日志：恢复上次会话，之后的每次提交都追加到日志
+    void enableAutosave(const QString &dir);
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
 private slots:
     void addComponent();
     void addWideComponent();
     void onFormMoved(const QRect &r);
+    void onFormPreviewMoved(const QRect &r);
     void onFormClose(CustomForm *f);
+    void onFormGeometryCommitted(const QRect &from, const QRect &to);
+    void onDragStarted();
+    void onDragFinished();
+    void onGroupDragStarted();
+    void onGroupDragMoved(const QPoint &delta);
+    void onGroupDragFinished();
+    void updateSelectionActions();
+    void autoArrange();
+    void undo();
+    void redo();
+    void updateHistoryActions();
     void saveLayout();
     void loadLayout();
+    void setSnapshotDrag(bool on);
+    void setProfilingEnabled(bool on);
+    void exportProfile();
+    void setOverviewMode(bool on);
+    void switchToPage(int index);
+    void addPage();
+    void closePage(int index);
+    void renamePage(int index);
+    void setLiveFeedEnabled(bool on);
+    void setLogStressEnabled(bool on);
+    void emitStressLogLines();
+    void jumpTo(const QPoint &canvasPos);
+    void updateViewportIndicators();
+    void updateMaterializedForms();
+    void onLayoutRecords(const QVector<FormRecord> &records);
+    void onLayoutPageName(int page, const QString &name);
+    void onLayoutLoaded(bool ok);
+    void cancelLayoutLoad();
+    void onLayoutSaved(const QString &fileName, bool ok, const QString &error);
 
 private:
     FormCanvas* container() const;
-    void maybeExpandContainer();
-    CustomForm* createForm(const QRect &geom);
-    QJsonArray serializeForms() const;
+    void updateContainerSize();
+    void trackFormGeometry(int id, const QRect &geom);
+    void untrackForm(int id);
+    // 批量事务：一次性落地全部几何，只重绘变动区域，只做一次容器尺寸与虚拟化更新
+    void applyGeometries(const QHash<int, QRect> &geoms);
+    void commitGeometries(const QHash<int, QRect> &before);
+    QHash<int, QRect> selectedGeometries() const;
+    // 避让模式下按被拖拽组件本帧的几何推开邻居
+    void pushAsideFrom(int id, const QRect &r);
+    // 结束避让手势，恢复吸附索引，返回被推开组件在手势开始时的几何
+    QHash<int, QRect> finishPushAside();
+    void alignSelection(Qt::AlignmentFlag edge);
+    QRect placeNewForm(const QRect &preferred) const;
+    void distributeSelection(Qt::Orientation orientation);
+    // page 为 -1 表示当前页；落在休眠页的记录只进该页的记录表
+    int createForm(const QRect &geom, const QJsonObject &state = QJsonObject(), bool materializeNow = true,
+                   int page = -1);
+    void addRecord(const FormRecord &rec, bool materializeNow);
+    void addRecordToPage(const FormRecord &rec, bool materializeNow);
+    void removeRecord(int id);
+    FormRecord currentRecord(const FormRecord &rec) const;
+    // 组件当前的界面状态，去掉压测时临时加上的合成数据源订阅
+    QJsonObject formState(int id, const CustomForm *f) const;
+    void subscribeSyntheticFeed(int id, CustomForm *f);
+    void recordCreated(int id);
+    void applyHistoryEntry(UndoHistory::Entry &entry, bool forward);
+    CustomForm* materializeForm(int id);
+    void releaseForm(int id);
+    // 组件 id 对应的日志缓冲，组件回收、页面休眠时保留
+    QSharedPointer<LogBuffer> logBuffer(int id);
+    CustomForm* acquireForm();
+    void recycleForm(CustomForm *f);
+    void scheduleVirtualization();
+    QRect visibleCanvasRect() const;
+    QVector<FormRecord> snapshotRecords() const;
+    // 全部页面的记录，休眠页直接取其记录表
+    QVector<FormRecord> workspaceRecords() const;
+    // 按页号排列的页面名称；只有一页且未改名时为空
+    QStringList workspacePageNames() const;
     void recreateFromJson(const QJsonArray &arr);
+    // 清空工作区并开始流式加载；文件打不开时返回 false，原有内容不动
+    bool loadLayoutFile(const QString &fileName);
+    // 清空整个工作区（全部页面），只留一个空白页
+    void clearForms();
+    // 只卸下当前页：组件回收进对象池，画布清空，不写日志；撤销历史由调用方保存或清空
+    void unloadForms();
+    void hibernateCurrentPage();
+    void activatePage(int index);
+    void ensurePage(int index);
+    // 把当前的页面列表写进自动保存日志
+    void journalPages();
+    void setPageName(int index, const QString &name);
+    static QString defaultPageName(int index);
 
 private:
     QScrollArea *m_area = nullptr;
     FormCanvas  *m_container = nullptr;
-    QList<QPointer<CustomForm>> m_forms;
+    QStackedWidget *m_centralStack = nullptr;        // 滚动区域与总览二选一
+    QTabBar     *m_pageBar = nullptr;
+    MinimapView *m_minimap = nullptr;
+    MinimapView *m_overview = nullptr;
+    QAction     *m_overviewAct = nullptr;
+    QMap<int, FormRecord> m_records;                 // 全部组件，按 id（创建顺序）排列
+    QHash<int, QPointer<CustomForm>> m_widgets;      // 已实例化的组件
+    QVector<CustomForm*> m_formPool;                 // 隐藏待复用的组件
+    QHash<int, QSharedPointer<LogBuffer>> m_logs;    // 各组件的日志，与组件实例的生命周期无关
+    CanvasExtents m_extents;
+    QTimer *m_virtualizeTimer = nullptr;
+    LayoutLoader *m_loader = nullptr;
+    LayoutSaver  *m_saver = nullptr;
+    LayoutJournal *m_journal = nullptr;
+    UndoHistory *m_history = nullptr;
+    LiveFeed    *m_liveFeed = nullptr;
+    bool         m_syntheticFeed = false;
+    QHash<int, QString> m_syntheticFeeds;            // 压测开关临时订阅的组件及其数据源，不进记录
+    QTimer      *m_logStressTimer = nullptr;
+    quint64      m_logStressSeq = 0;
+    QAction *m_undoAct = nullptr;
+    QAction *m_redoAct = nullptr;
+    QProgressBar *m_loadProgress = nullptr;
+    QToolButton  *m_loadCancel = nullptr;
+    QToolButton  *m_alignButton = nullptr;
+    QAction      *m_distributeH = nullptr;
+    QAction      *m_distributeV = nullptr;
+    QHash<int, QRect> m_groupDragOrigin;             // 整组拖拽开始时各成员的几何
+    int m_dragFormId = -1;                           // 正在拖拽（含整组拖拽时按住）的组件，虚拟化不释放它
+    QElapsedTimer m_loadTimer;
+
+    // 工作区页面：当前页的组件在 m_records 与画布上，其余页面休眠，只保留记录、滚动位置与撤销历史
+    struct WorkspacePage {
+        QString name;
+        QVector<FormRecord> records;
+        QPoint scroll;
+        UndoHistory::State history;
+    };
+    QVector<WorkspacePage> m_pages;
+    int m_currentPage = 0;
+    int m_nextFormId = 0;
+    bool m_snapshotDrag = false;
+    bool m_placeInFreeSpace = false;
+    bool m_noOverlap = false;
+    PushAsideResolver m_pushAside;
 };
\ No newline at end of file
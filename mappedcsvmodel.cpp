@@ -0,0 +1,254 @@
+#include "mappedcsvmodel.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QThread>
+#include <QWeakPointer>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr int kInitialRows = 1000;          // 索引一到就直接暴露的行数
+constexpr int kFetchBatch = 50000;          // 每次 fetchMore 暴露的行数
+constexpr int kIndexBatch = 65536;          // 后台线程每批上报的行数
+
+// 从 pos 开始的一条记录的结束偏移（不含换行）。双引号内的换行属于字段内容；
+// "" 转义让引号状态翻转两次，按奇偶计数即可。没有引号的行只需两次 memchr
+qint64 recordEnd(const char *data, qint64 size, qint64 pos)
+{
+    bool quoted = false;
+    while (pos < size) {
+        const char *nl = static_cast<const char*>(std::memchr(data + pos, '\n', size_t(size - pos)));
+        const char *lineEnd = nl ? nl : data + size;
+        const char *q = data + pos;
+        while ((q = static_cast<const char*>(std::memchr(q, '"', size_t(lineEnd - q))))) {
+            quoted = !quoted;
+            ++q;
+        }
+        if (!quoted)
+            return lineEnd - data;
+        pos = lineEnd - data + 1;
+    }
+    // 引号未闭合时把剩余内容算作一条记录
+    return size;
+}
+}
+
+MappedCsvModel::MappedCsvModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+MappedCsvModel::~MappedCsvModel()
+{
+    stopIndexing();
+}
+
+QSharedPointer<MappedCsvModel> MappedCsvModel::shared(const QString &path)
+{
+    // 仅在 GUI 线程使用
+    static QHash<QString, QWeakPointer<MappedCsvModel>> registry;
+
+    const QString key = QFileInfo(path).absoluteFilePath();
+    if (QSharedPointer<MappedCsvModel> existing = registry.value(key).toStrongRef())
+        return existing;
+
+    QSharedPointer<MappedCsvModel> model(new MappedCsvModel, &QObject::deleteLater);
+    if (!model->open(key))
+        return model;
+    registry.insert(key, model.toWeakRef());
+    return model;
+}
+
+bool MappedCsvModel::open(const QString &path)
+{
+    beginResetModel();
+    stopIndexing();
+    if (m_file.isOpen()) {
+        if (m_data)
+            m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+        m_file.close();
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_header.clear();
+    m_rowEnds.clear();
+    m_rowCount = 0;
+    m_cachedRow = -1;
+    m_cachedFields.clear();
+    m_error.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        endResetModel();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+        if (!m_data) {
+            m_error = m_file.errorString();
+            m_file.close();
+            m_size = 0;
+            endResetModel();
+            return false;
+        }
+    }
+
+    m_delimiter = path.endsWith(QLatin1String(".tsv"), Qt::CaseInsensitive) ? '\t' : ',';
+
+    // 表头同步解析，只看第一条记录
+    const qint64 headerEnd = m_data ? recordEnd(m_data, m_size, 0) : 0;
+    m_header = parseLine(0, headerEnd);
+    m_firstRow = std::min(headerEnd + 1, m_size);
+    endResetModel();
+
+    startIndexing(m_firstRow);
+    return true;
+}
+
+void MappedCsvModel::startIndexing(qint64 from)
+{
+    if (from >= m_size) {
+        m_indexFinished = true;
+        emit indexingProgress(0, true);
+        return;
+    }
+
+    m_indexFinished = false;
+    m_stop = false;
+    const char *data = m_data;
+    const qint64 size = m_size;
+
+    m_indexer = QThread::create([this, data, size, from]() {
+        QVector<qint64> batch;
+        batch.reserve(kIndexBatch);
+        qint64 pos = from;
+        while (pos < size && !m_stop.load(std::memory_order_relaxed)) {
+            const qint64 end = recordEnd(data, size, pos);
+            batch.append(end);
+            pos = end + 1;
+            if (batch.size() >= kIndexBatch) {
+                // 结果回投到 GUI 线程追加，索引数组只在 GUI 线程访问
+                QMetaObject::invokeMethod(this, [this, batch]() { appendRowEnds(batch, false); },
+                                          Qt::QueuedConnection);
+                batch.clear();
+            }
+        }
+        if (!m_stop.load(std::memory_order_relaxed))
+            QMetaObject::invokeMethod(this, [this, batch]() { appendRowEnds(batch, true); },
+                                      Qt::QueuedConnection);
+    });
+    m_indexer->start(QThread::LowPriority);
+}
+
+void MappedCsvModel::stopIndexing()
+{
+    if (!m_indexer)
+        return;
+    m_stop = true;
+    m_indexer->wait();
+    delete m_indexer;
+    m_indexer = nullptr;
+    m_indexFinished = true;
+}
+
+void MappedCsvModel::appendRowEnds(const QVector<qint64> &ends, bool finished)
+{
+    m_rowEnds += ends;
+    if (finished)
+        m_indexFinished = true;
+
+    if (m_rowCount < kInitialRows && canFetchMore(QModelIndex()))
+        fetchMore(QModelIndex());
+    emit indexingProgress(int(m_rowEnds.size()), m_indexFinished);
+}
+
+int MappedCsvModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int MappedCsvModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_header.size());
+}
+
+QVariant MappedCsvModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= m_rowCount)
+        return QVariant();
+
+    if (m_cachedRow != index.row()) {
+        const int row = index.row();
+        const qint64 begin = row == 0 ? m_firstRow : m_rowEnds.at(row - 1) + 1;
+        m_cachedFields = parseLine(begin, m_rowEnds.at(row));
+        m_cachedRow = row;
+    }
+    return m_cachedFields.value(index.column());
+}
+
+QVariant MappedCsvModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Horizontal)
+        return m_header.value(section);
+    return section + 1;
+}
+
+bool MappedCsvModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_rowCount < m_rowEnds.size();
+}
+
+void MappedCsvModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+    const int available = int(m_rowEnds.size()) - m_rowCount;
+    const int count = std::min(available, kFetchBatch);
+    if (count <= 0)
+        return;
+    beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + count - 1);
+    m_rowCount += count;
+    endInsertRows();
+}
+
+QStringList MappedCsvModel::parseLine(qint64 begin, qint64 end) const
+{
+    QStringList fields;
+    if (!m_data)
+        return fields;
+    if (end > begin && m_data[end - 1] == '\r')
+        --end;
+
+    // 支持双引号包裹与 "" 转义的最小 CSV 解析
+    QByteArray field;
+    bool quoted = false;
+    for (qint64 i = begin; i < end; ++i) {
+        const char ch = m_data[i];
+        if (quoted) {
+            if (ch == '"') {
+                if (i + 1 < end && m_data[i + 1] == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += ch;
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == m_delimiter) {
+            fields << QString::fromUtf8(field);
+            field.clear();
+        } else {
+            field += ch;
+        }
+    }
+    fields << QString::fromUtf8(field);
+    return fields;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QFile>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+class QThread;
+
+// 内存映射的 CSV/TSV 数据源：文件不读入内存，后台线程建立行偏移索引，
+// data() 按需解析所在行；已索引的行通过 canFetchMore/fetchMore 逐步暴露给视图
+class MappedCsvModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit MappedCsvModel(QObject *parent = nullptr);
+    ~MappedCsvModel() override;
+
+    // 同一路径的文件在多个组件间共享一个实例
+    static QSharedPointer<MappedCsvModel> shared(const QString &path);
+
+    bool open(const QString &path);
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+
+    int indexedRowCount() const { return int(m_rowEnds.size()); }
+    bool isIndexing() const { return !m_indexFinished; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void indexingProgress(int indexedRows, bool finished);
+
+private:
+    void startIndexing(qint64 from);
+    void stopIndexing();
+    void appendRowEnds(const QVector<qint64> &ends, bool finished);
+    QStringList parseLine(qint64 begin, qint64 end) const;
+
+    QFile m_file;
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+    char m_delimiter = ',';
+    QString m_error;
+
+    QStringList m_header;
+    qint64 m_firstRow = 0;          // 表头之后第一行的起始偏移
+    QVector<qint64> m_rowEnds;      // 每条记录的结束偏移（不含换行，引号内换行不算），仅在 GUI 线程读写
+    bool m_indexFinished = true;
+    int m_rowCount = 0;             // 已暴露给视图的行数
+
+    QThread *m_indexer = nullptr;
+    std::atomic_bool m_stop { false };
+
+    // 同一行的多列通常连续请求，缓存最近解析的一行
+    mutable int m_cachedRow = -1;
+    mutable QStringList m_cachedFields;
+};
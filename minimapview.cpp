@@ -0,0 +1,164 @@
+#include "minimapview.h"
+#include "formcanvas.h"
+#include "customform.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QShowEvent>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QColor>
+#include <QPen>
+#include <algorithm>
+
+MinimapView::MinimapView(FormCanvas *canvas, QWidget *parent)
+    : QWidget(parent)
+    , m_canvas(canvas)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
+    setMinimumSize(120, 80);
+    setCursor(Qt::PointingHandCursor);
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &MinimapView::refreshThumbnails);
+    connect(m_canvas, &FormCanvas::formsChanged, this, &MinimapView::scheduleRefresh);
+    connect(m_canvas, &FormCanvas::selectionChanged, this, &MinimapView::scheduleRefresh);
+}
+
+void MinimapView::setViewportRect(const QRect &canvasRect)
+{
+    if (canvasRect == m_viewport)
+        return;
+    m_viewport = canvasRect;
+    update();
+}
+
+void MinimapView::scheduleRefresh()
+{
+    // 拖拽时每帧都会触发，只在定时器空闲时启动，合并成一次重绘
+    if (isVisible() && !m_refreshTimer->isActive())
+        m_refreshTimer->start();
+}
+
+void MinimapView::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    scheduleRefresh();
+}
+
+void MinimapView::refreshThumbnails()
+{
+    if (!isVisible())
+        return;
+
+    // 缩略图在绘制之外抓取：只抓已实例化、且内容或尺寸变过、缩小后仍看得清的组件
+    const QRectF content = contentRect();
+    const qreal scale = content.width() / std::max(1, m_canvas->width());
+    ThumbnailCache &cache = m_canvas->thumbnails();
+    const QHash<int, QRect> &forms = m_canvas->formGrid().rects();
+
+    QElapsedTimer budget;
+    budget.start();
+    bool pending = false;
+    for (auto it = forms.cbegin(); it != forms.cend(); ++it) {
+        if (it.value().width() * scale < kMinThumbnailEdge)
+            continue;
+        if (!cache.needsRefresh(it.key(), it.value().size()))
+            continue;
+        CustomForm *form = m_canvas->liveForm(it.key());
+        if (!form)
+            continue;
+        if (budget.elapsed() >= kThumbnailBudgetMs) {
+            pending = true;
+            break;
+        }
+        cache.refresh(it.key(), form);
+    }
+    update();
+    if (pending)
+        m_refreshTimer->start();
+}
+
+QRectF MinimapView::contentRect() const
+{
+    // 画布按比例居中放进部件，留 4px 边
+    const QRectF avail = QRectF(rect()).adjusted(4, 4, -4, -4);
+    const QSizeF canvas(std::max(1, m_canvas->width()), std::max(1, m_canvas->height()));
+    const qreal scale = std::min(avail.width() / canvas.width(), avail.height() / canvas.height());
+    const QSizeF size = canvas * scale;
+    return QRectF(avail.center() - QPointF(size.width() / 2, size.height() / 2), size);
+}
+
+QRectF MinimapView::toView(const QRect &canvasRect, const QRectF &content, qreal scale) const
+{
+    return QRectF(content.topLeft() + QPointF(canvasRect.topLeft()) * scale,
+                  QSizeF(canvasRect.size()) * scale);
+}
+
+QPoint MinimapView::toCanvas(const QPointF &pos) const
+{
+    const QRectF content = contentRect();
+    const qreal scale = content.width() / std::max(1, m_canvas->width());
+    return ((pos - content.topLeft()) / scale).toPoint();
+}
+
+void MinimapView::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), QColor(24, 24, 26));
+
+    const QRectF content = contentRect();
+    const qreal scale = content.width() / std::max(1, m_canvas->width());
+    p.fillRect(content, QColor(36, 36, 38));
+
+    // 按 id（创建顺序）绘制，与画布上的叠放次序一致
+    const QHash<int, QRect> &forms = m_canvas->formGrid().rects();
+    QList<int> ids = forms.keys();
+    std::sort(ids.begin(), ids.end());
+
+    const ThumbnailCache &cache = m_canvas->thumbnails();
+    const QColor fill(70, 70, 76);
+    const QColor selectedFill(66, 133, 244);
+    for (int id : std::as_const(ids)) {
+        const QRectF target = toView(forms.value(id), content, scale);
+        if (target.width() >= kMinThumbnailEdge) {
+            const QPixmap thumb = cache.thumbnail(id);
+            if (!thumb.isNull()) {
+                p.drawPixmap(target, thumb, QRectF(thumb.rect()));
+                if (m_canvas->isSelected(id)) {
+                    p.setPen(QPen(selectedFill, 1));
+                    p.drawRect(target);
+                }
+                continue;
+            }
+        }
+        p.fillRect(target, m_canvas->isSelected(id) ? selectedFill : fill);
+    }
+
+    if (m_viewport.isValid()) {
+        p.setPen(QPen(QColor(255, 255, 255, 200), 1));
+        p.setBrush(QColor(255, 255, 255, 24));
+        p.drawRect(toView(m_viewport, content, scale));
+    }
+}
+
+void MinimapView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    emit jumpRequested(toCanvas(event->position()));
+}
+
+void MinimapView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton)) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    emit jumpRequested(toCanvas(event->position()));
+}
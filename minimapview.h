@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QWidget>
+#include <QRect>
+#include <QRectF>
+
+class FormCanvas;
+class QTimer;
+
+// 画布概览：按比例缩小绘制全部组件，组件用缓存的缩略图，当前视口画成描边框；
+// 点击或拖动跳转视口。开销只与组件数和缩略图尺寸有关，从不重绘画布本身
+class MinimapView : public QWidget
+{
+    Q_OBJECT
+public:
+    static constexpr int kRefreshIntervalMs = 100;  // 画布变化后的重绘节流
+    static constexpr int kThumbnailBudgetMs = 8;    // 单轮抓取缩略图的时间预算
+    static constexpr int kMinThumbnailEdge = 24;    // 缩小后不足该宽度的组件只画色块
+
+    explicit MinimapView(FormCanvas *canvas, QWidget *parent = nullptr);
+
+    void setViewportRect(const QRect &canvasRect);
+    QSize sizeHint() const override { return QSize(240, 160); }
+
+signals:
+    // 请求把视口中心移到画布坐标 canvasPos
+    void jumpRequested(const QPoint &canvasPos);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void scheduleRefresh();
+    void refreshThumbnails();
+    QRectF contentRect() const;
+    QRectF toView(const QRect &canvasRect, const QRectF &content, qreal scale) const;
+    QPoint toCanvas(const QPointF &pos) const;
+
+    FormCanvas *m_canvas = nullptr;
+    QTimer *m_refreshTimer = nullptr;
+    QRect m_viewport;
+};
@@ -0,0 +1,121 @@
+#include "pushaside.h"
+
+#include <QVector>
+#include <algorithm>
+
+void PushAsideResolver::begin(const SpatialGrid &forms, int draggedId, const QPoint &topLeft)
+{
+    m_base = forms;
+    m_base.remove(draggedId);
+    m_topLeft = topLeft;
+    m_dragged = draggedId;
+    m_moved.clear();
+    m_touched.clear();
+}
+
+void PushAsideResolver::end()
+{
+    m_base.clear();
+    m_dragged = -1;
+    m_moved.clear();
+    m_touched.clear();
+}
+
+QHash<int, QRect> PushAsideResolver::resolve(const QRect &dragged)
+{
+    struct Push {
+        int id;
+        QRect rect;
+        Direction dir;
+    };
+
+    QHash<int, QRect> moved;
+    QVector<Push> queue;
+    queue.append({m_dragged, dragged, Down});
+
+    auto effective = [&](int id) {
+        const auto it = moved.constFind(id);
+        return it != moved.constEnd() ? it.value() : m_base.rect(id);
+    };
+
+    int steps = 0;
+    for (int head = 0; head < queue.size() && steps < kMaxSteps; ++head) {
+        const Push p = queue.at(head);
+        if (p.id != m_dragged && moved.value(p.id) != p.rect)
+            continue;   // 已被后续推动覆盖，按最新位置的那一项处理
+
+        // 候选：原位在附近的组件，加上本帧已被推到别处的组件
+        QVector<int> candidates = m_base.query(p.rect);
+        for (auto it = moved.cbegin(); it != moved.cend(); ++it) {
+            if (it.value().intersects(p.rect) && !candidates.contains(it.key()))
+                candidates.append(it.key());
+        }
+
+        for (int id : std::as_const(candidates)) {
+            if (id == p.id || id == m_dragged)
+                continue;
+            const QRect other = effective(id);
+            if (!other.intersects(p.rect))
+                continue;
+            // 拖拽组件按相对位置决定方向，被推开的组件沿用推它的方向，级联只朝一个方向单调前进
+            Direction dir = p.id == m_dragged ? directionFor(p.rect, other) : p.dir;
+            QRect pushed = pushOut(p.rect, other, dir);
+            if (pushed.left() < m_topLeft.x() || pushed.top() < m_topLeft.y()) {
+                // 顶到画布左/上边界：改走另一轴，朝远离拖拽组件的一侧，不往回推向拖拽组件
+                if (dir == Up)
+                    dir = other.center().x() < dragged.center().x() ? Left : Right;
+                else
+                    dir = other.center().y() < dragged.center().y() ? Up : Down;
+                pushed = pushOut(p.rect, other, dir);
+                if (pushed.left() < m_topLeft.x() || pushed.top() < m_topLeft.y()) {
+                    dir = dir == Left ? Right : Down;
+                    pushed = pushOut(p.rect, other, dir);
+                }
+            }
+            moved.insert(id, pushed);
+            queue.append({id, pushed, dir});
+            ++steps;
+        }
+    }
+
+    // 上一帧推开过、本帧不再受影响的组件回到原位
+    QHash<int, QRect> result = moved;
+    for (auto it = m_moved.cbegin(); it != m_moved.cend(); ++it) {
+        if (!moved.contains(it.key()))
+            result.insert(it.key(), m_base.rect(it.key()));
+    }
+    for (auto it = moved.cbegin(); it != moved.cend(); ++it)
+        m_touched.insert(it.key());
+    m_moved = moved;
+    return result;
+}
+
+QHash<int, QRect> PushAsideResolver::touchedOrigins() const
+{
+    QHash<int, QRect> origins;
+    for (int id : m_touched)
+        origins.insert(id, m_base.rect(id));
+    return origins;
+}
+
+PushAsideResolver::Direction PushAsideResolver::directionFor(const QRect &mover, const QRect &other)
+{
+    // 沿重叠较浅的轴推开，方向取两者中心的相对位置
+    const int overlapX = std::min(mover.right(), other.right()) - std::max(mover.left(), other.left()) + 1;
+    const int overlapY = std::min(mover.bottom(), other.bottom()) - std::max(mover.top(), other.top()) + 1;
+    const QPoint d = other.center() - mover.center();
+    if (overlapX <= overlapY)
+        return d.x() >= 0 ? Right : Left;
+    return d.y() >= 0 ? Down : Up;
+}
+
+QRect PushAsideResolver::pushOut(const QRect &mover, const QRect &other, Direction dir)
+{
+    switch (dir) {
+    case Left:  return other.translated(mover.left() - 1 - other.right(), 0);
+    case Right: return other.translated(mover.right() + 1 - other.left(), 0);
+    case Up:    return other.translated(0, mover.top() - 1 - other.bottom());
+    case Down:  return other.translated(0, mover.bottom() + 1 - other.top());
+    }
+    return other;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QSet>
+
+#include "spatialgrid.h"
+
+// 避让模式：拖拽或缩放中的组件把与之重叠的组件推开，被推开的组件继续推它碰到的。
+// 每帧都从手势开始时的位置重新求解，拖走后被推开的组件会回到原处；
+// 碰撞只在空间网格里查询受影响的邻域，不做两两遍历
+class PushAsideResolver
+{
+public:
+    static constexpr int kMaxSteps = 4096;   // 单帧最多推动次数，防止级联来回震荡
+
+    // forms 为手势开始时全部组件的几何；共享拷贝，画布之后的修改不影响这里。
+    // 被推开的组件不越过 topLeft 所在的画布左/上边界
+    void begin(const SpatialGrid &forms, int draggedId, const QPoint &topLeft = QPoint(0, 0));
+    void end();
+    bool isActive() const { return m_dragged >= 0; }
+    int draggedId() const { return m_dragged; }
+
+    // 返回本帧需要落地的几何：被推开的组件的新位置，以及上一帧被推开、本帧恢复原位的组件
+    QHash<int, QRect> resolve(const QRect &dragged);
+
+    // 手势期间动过的组件在开始时的几何，用于合成一条撤销记录
+    QHash<int, QRect> touchedOrigins() const;
+    // 手势期间动过的组件；它们的位置逐帧变化，不应作为吸附目标
+    const QSet<int> &touchedIds() const { return m_touched; }
+
+private:
+    enum Direction { Left, Right, Up, Down };
+
+    static Direction directionFor(const QRect &mover, const QRect &other);
+    static QRect pushOut(const QRect &mover, const QRect &other, Direction dir);
+
+    SpatialGrid m_base;
+    QPoint m_topLeft;
+    int m_dragged = -1;
+    QHash<int, QRect> m_moved;      // 上一帧被推开的组件及其位置
+    QSet<int> m_touched;
+};
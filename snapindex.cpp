@@ -0,0 +1,147 @@
+#include "snapindex.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+void SnapIndex::insert(int key, const QRect &rect)
+{
+    auto it = m_rects.find(key);
+    if (it != m_rects.end()) {
+        if (*it == rect)
+            return;
+        removeEdge(m_vertical, it->left());
+        removeEdge(m_vertical, it->right());
+        removeEdge(m_horizontal, it->top());
+        removeEdge(m_horizontal, it->bottom());
+        *it = rect;
+    } else {
+        m_rects.insert(key, rect);
+    }
+    addEdge(m_vertical, rect.left());
+    addEdge(m_vertical, rect.right());
+    addEdge(m_horizontal, rect.top());
+    addEdge(m_horizontal, rect.bottom());
+}
+
+void SnapIndex::remove(int key)
+{
+    auto it = m_rects.find(key);
+    if (it == m_rects.end())
+        return;
+    removeEdge(m_vertical, it->left());
+    removeEdge(m_vertical, it->right());
+    removeEdge(m_horizontal, it->top());
+    removeEdge(m_horizontal, it->bottom());
+    m_rects.erase(it);
+}
+
+void SnapIndex::clear()
+{
+    m_rects.clear();
+    m_vertical.clear();
+    m_horizontal.clear();
+}
+
+SnapIndex::Match SnapIndex::nearestVertical(int value, int threshold, int excludeKey) const
+{
+    const auto it = m_rects.constFind(excludeKey);
+    if (it == m_rects.constEnd())
+        return nearest(m_vertical, value, threshold, 0, 0, false);
+    return nearest(m_vertical, value, threshold, it->left(), it->right(), true);
+}
+
+SnapIndex::Match SnapIndex::nearestHorizontal(int value, int threshold, int excludeKey) const
+{
+    const auto it = m_rects.constFind(excludeKey);
+    if (it == m_rects.constEnd())
+        return nearest(m_horizontal, value, threshold, 0, 0, false);
+    return nearest(m_horizontal, value, threshold, it->top(), it->bottom(), true);
+}
+
+SnapIndex::Match SnapIndex::nearestGrid(int value, int origin, int limit, int gridSize, int threshold)
+{
+    Match m;
+    if (gridSize <= 0 || limit < origin)
+        return m;
+
+    // 四舍五入到最近的网格序号，并限制在 [origin, limit] 内
+    const int offset = value - origin;
+    int k = offset >= 0 ? (offset + gridSize / 2) / gridSize
+                        : -((-offset + gridSize / 2) / gridSize);
+    k = std::max(0, std::min(k, (limit - origin) / gridSize));
+
+    const int target = origin + k * gridSize;
+    const int diff = std::abs(target - value);
+    if (diff <= threshold) {
+        m.matched = true;
+        m.target = target;
+        m.diff = diff;
+    }
+    return m;
+}
+
+SnapIndex::Match SnapIndex::better(const Match &a, const Match &b)
+{
+    if (!b.matched)
+        return a;
+    if (!a.matched || b.diff < a.diff)
+        return b;
+    return a;
+}
+
+void SnapIndex::addEdge(EdgeMap &edges, int value)
+{
+    ++edges[value];
+}
+
+void SnapIndex::removeEdge(EdgeMap &edges, int value)
+{
+    auto it = edges.find(value);
+    if (it == edges.end())
+        return;
+    if (--it->second <= 0)
+        edges.erase(it);
+}
+
+SnapIndex::Match SnapIndex::nearest(const EdgeMap &edges, int value, int threshold,
+                                    int skipA, int skipB, bool skip)
+{
+    // 扣除被排除组件自身贡献的引用计数后仍有剩余才算候选
+    auto available = [&](EdgeMap::const_iterator it) {
+        int count = it->second;
+        if (skip) {
+            if (it->first == skipA) --count;
+            if (it->first == skipB) --count;
+        }
+        return count > 0;
+    };
+
+    Match m;
+
+    auto up = edges.lower_bound(value);
+    for (; up != edges.end() && up->first - value <= threshold; ++up) {
+        if (available(up)) {
+            m.matched = true;
+            m.target = up->first;
+            m.diff = up->first - value;
+            break;
+        }
+    }
+
+    auto down = edges.lower_bound(value);
+    while (down != edges.begin()) {
+        --down;
+        const int diff = value - down->first;
+        if (diff > threshold || (m.matched && diff > m.diff))
+            break;
+        if (available(down)) {
+            // 距离相同时取较小坐标
+            m.matched = true;
+            m.target = down->first;
+            m.diff = diff;
+            break;
+        }
+    }
+
+    return m;
+}
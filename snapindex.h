@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QHash>
+#include <QRect>
+#include <map>
+
+// 兄弟组件边缘的有序索引：组件几何变化时增量维护，吸附时二分查找最近边
+class SnapIndex
+{
+public:
+    struct Match {
+        bool matched = false;
+        int target = 0;
+        int diff = 0;
+    };
+
+    void insert(int key, const QRect &rect);   // 已存在则更新
+    void remove(int key);
+    void clear();
+
+    bool contains(int key) const { return m_rects.contains(key); }
+    int size() const { return int(m_rects.size()); }
+
+    // excludeKey 对应组件自身的边不参与匹配
+    Match nearestVertical(int value, int threshold, int excludeKey = -1) const;
+    Match nearestHorizontal(int value, int threshold, int excludeKey = -1) const;
+
+    // 网格线 origin + k * gridSize（不超过 limit）中距离 value 最近的一条
+    static Match nearestGrid(int value, int origin, int limit, int gridSize, int threshold);
+    static Match better(const Match &a, const Match &b);
+
+private:
+    using EdgeMap = std::map<int, int>; // 边坐标 -> 引用计数
+
+    static void addEdge(EdgeMap &edges, int value);
+    static void removeEdge(EdgeMap &edges, int value);
+    static Match nearest(const EdgeMap &edges, int value, int threshold, int skipA, int skipB, bool skip);
+
+    QHash<int, QRect> m_rects;
+    EdgeMap m_vertical;
+    EdgeMap m_horizontal;
+};
@@ -0,0 +1,105 @@
+#include "spatialgrid.h"
+
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(int cellSize)
+    : m_cellSize(std::max(1, cellSize))
+{
+}
+
+void SpatialGrid::insert(int key, const QRect &rect)
+{
+    auto it = m_rects.find(key);
+    if (it != m_rects.end()) {
+        if (*it == rect)
+            return;
+        removeFromCells(key, *it);
+        *it = rect;
+    } else {
+        m_rects.insert(key, rect);
+    }
+    addToCells(key, rect);
+}
+
+void SpatialGrid::remove(int key)
+{
+    auto it = m_rects.find(key);
+    if (it == m_rects.end())
+        return;
+    removeFromCells(key, *it);
+    m_rects.erase(it);
+}
+
+void SpatialGrid::clear()
+{
+    m_rects.clear();
+    m_cells.clear();
+}
+
+QVector<int> SpatialGrid::query(const QRect &area) const
+{
+    QVector<int> result;
+    if (area.isEmpty())
+        return result;
+
+    const CellRange range = cellsFor(area);
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx) {
+            const auto cell = m_cells.constFind(cellKey(cx, cy));
+            if (cell == m_cells.constEnd())
+                continue;
+            for (int key : *cell) {
+                const QRect hit = m_rects.value(key) & area;
+                if (hit.isEmpty())
+                    continue;
+                // 只在交集左上角所在的单元上报，避免跨单元的重复
+                if (cellOf(hit.left()) == cx && cellOf(hit.top()) == cy)
+                    result.append(key);
+            }
+        }
+    }
+    return result;
+}
+
+SpatialGrid::CellRange SpatialGrid::cellsFor(const QRect &rect) const
+{
+    return { cellOf(rect.left()), cellOf(rect.top()), cellOf(rect.right()), cellOf(rect.bottom()) };
+}
+
+int SpatialGrid::cellOf(int v) const
+{
+    // 向下取整，负坐标也落在正确的单元
+    return v >= 0 ? v / m_cellSize : -((-v + m_cellSize - 1) / m_cellSize);
+}
+
+quint64 SpatialGrid::cellKey(int cx, int cy)
+{
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+void SpatialGrid::addToCells(int key, const QRect &rect)
+{
+    if (rect.isEmpty())
+        return;
+    const CellRange range = cellsFor(rect);
+    for (int cy = range.y0; cy <= range.y1; ++cy)
+        for (int cx = range.x0; cx <= range.x1; ++cx)
+            m_cells[cellKey(cx, cy)].append(key);
+}
+
+void SpatialGrid::removeFromCells(int key, const QRect &rect)
+{
+    if (rect.isEmpty())
+        return;
+    const CellRange range = cellsFor(rect);
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx) {
+            auto cell = m_cells.find(cellKey(cx, cy));
+            if (cell == m_cells.end())
+                continue;
+            cell->removeOne(key);
+            if (cell->isEmpty())
+                m_cells.erase(cell);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QHash>
+#include <QRect>
+#include <QVector>
+
+// 均匀分桶的空间索引：按矩形覆盖的网格单元登记，区域查询只访问相交单元
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(int cellSize = 256);
+
+    void insert(int key, const QRect &rect);   // 已存在则更新
+    void remove(int key);
+    void clear();
+
+    bool contains(int key) const { return m_rects.contains(key); }
+    QRect rect(int key) const { return m_rects.value(key); }
+    int size() const { return int(m_rects.size()); }
+    const QHash<int, QRect> &rects() const { return m_rects; }
+
+    // 与 area 相交的所有 key，每个只出现一次
+    QVector<int> query(const QRect &area) const;
+
+private:
+    struct CellRange {
+        int x0, y0, x1, y1;
+    };
+
+    CellRange cellsFor(const QRect &rect) const;
+    int cellOf(int v) const;
+    static quint64 cellKey(int cx, int cy);
+    void addToCells(int key, const QRect &rect);
+    void removeFromCells(int key, const QRect &rect);
+
+    int m_cellSize;
+    QHash<int, QRect> m_rects;
+    QHash<quint64, QVector<int>> m_cells;
+};
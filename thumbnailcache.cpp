@@ -0,0 +1,66 @@
+#include "thumbnailcache.h"
+
+#include <QPainter>
+#include <QWidget>
+#include <algorithm>
+
+ThumbnailCache::ThumbnailCache()
+    : m_cache(kDefaultCostLimit)
+{
+}
+
+QPixmap ThumbnailCache::thumbnail(int id) const
+{
+    if (const Thumb *t = m_cache.object(id))
+        return t->pixmap;
+    return QPixmap();
+}
+
+bool ThumbnailCache::needsRefresh(int id, const QSize &formSize) const
+{
+    const Thumb *t = m_cache.object(id);
+    return !t || m_dirty.contains(id) || t->sourceSize != formSize;
+}
+
+void ThumbnailCache::refresh(int id, QWidget *form)
+{
+    if (!form)
+        return;
+    const QSize source = form->size();
+    if (source.isEmpty())
+        return;
+    // 直接按缩略图尺寸绘制，不先抓一张全分辨率（含高分屏倍率）的图再缩小
+    const QSize target = source.width() > kMaxEdge || source.height() > kMaxEdge
+            ? source.scaled(QSize(kMaxEdge, kMaxEdge), Qt::KeepAspectRatio).expandedTo(QSize(1, 1))
+            : source;
+    QPixmap pixmap(target);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.scale(qreal(target.width()) / source.width(), qreal(target.height()) / source.height());
+        form->render(&painter, QPoint(), QRegion(), QWidget::DrawWindowBackground | QWidget::DrawChildren);
+    }
+
+    const int cost = std::max(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8);
+    m_cache.insert(id, new Thumb{pixmap, source}, cost);
+    m_dirty.remove(id);
+}
+
+void ThumbnailCache::invalidate(int id)
+{
+    m_dirty.insert(id);
+}
+
+void ThumbnailCache::remove(int id)
+{
+    m_cache.remove(id);
+    m_dirty.remove(id);
+}
+
+void ThumbnailCache::clear()
+{
+    m_cache.clear();
+    m_dirty.clear();
+}
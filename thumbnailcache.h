@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QCache>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+
+class QWidget;
+
+// 组件缩略图缓存：只在内容变化或尺寸变化后重新抓取，按像素字节数限制总量
+class ThumbnailCache
+{
+public:
+    static constexpr int kMaxEdge = 160;                        // 缩略图长边上限
+    static constexpr int kDefaultCostLimit = 48 * 1024 * 1024;  // 字节
+
+    ThumbnailCache();
+
+    void setCostLimit(int bytes) { m_cache.setMaxCost(bytes); }
+
+    // 可能已过期的缩略图；没有缓存时返回空图
+    QPixmap thumbnail(int id) const;
+    bool needsRefresh(int id, const QSize &formSize) const;
+
+    // 按缩略图尺寸绘制一次组件外观并保存
+    void refresh(int id, QWidget *form);
+
+    void invalidate(int id);
+    void remove(int id);
+    void clear();
+
+private:
+    struct Thumb {
+        QPixmap pixmap;
+        QSize sourceSize;
+    };
+
+    QCache<int, Thumb> m_cache;
+    QSet<int> m_dirty;
+};
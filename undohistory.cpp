@@ -0,0 +1,150 @@
+#include "undohistory.h"
+
+#include <QJsonDocument>
+#include <algorithm>
+
+UndoHistory::UndoHistory(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void UndoHistory::setMemoryLimit(qsizetype bytes)
+{
+    m_limit = std::max<qsizetype>(bytes, 0);
+    trim();
+    emit changed();
+}
+
+void UndoHistory::record(Entry entry)
+{
+    if (entry.isEmpty())
+        return;
+    for (const Stored &s : std::as_const(m_redo))
+        m_usage -= s.bytes;
+    m_redo.clear();
+    push(m_undo, std::move(entry));
+    trim();
+    emit changed();
+}
+
+UndoHistory::Entry UndoHistory::takeUndo()
+{
+    return take(m_undo);
+}
+
+void UndoHistory::finishUndo(Entry entry)
+{
+    push(m_redo, std::move(entry));
+    trim();
+    emit changed();
+}
+
+UndoHistory::Entry UndoHistory::takeRedo()
+{
+    return take(m_redo);
+}
+
+void UndoHistory::finishRedo(Entry entry)
+{
+    push(m_undo, std::move(entry));
+    trim();
+    emit changed();
+}
+
+void UndoHistory::clear()
+{
+    if (m_undo.isEmpty() && m_redo.isEmpty())
+        return;
+    m_undo.clear();
+    m_redo.clear();
+    m_usage = 0;
+    emit changed();
+}
+
+UndoHistory::State UndoHistory::takeState()
+{
+    State state;
+    state.undo = std::move(m_undo);
+    state.redo = std::move(m_redo);
+    state.usage = m_usage;
+    m_undo.clear();
+    m_redo.clear();
+    m_usage = 0;
+    emit changed();
+    return state;
+}
+
+void UndoHistory::restoreState(State state)
+{
+    m_undo = std::move(state.undo);
+    m_redo = std::move(state.redo);
+    m_usage = state.usage;
+    trim();
+    emit changed();
+}
+
+UndoHistory::GeometryDelta UndoHistory::delta(int id, const QRect &from, const QRect &to)
+{
+    GeometryDelta d;
+    d.id = id;
+    d.dx = to.x() - from.x();
+    d.dy = to.y() - from.y();
+    d.dw = to.width() - from.width();
+    d.dh = to.height() - from.height();
+    return d;
+}
+
+QRect UndoHistory::apply(const QRect &geom, const GeometryDelta &d, bool forward)
+{
+    const int s = forward ? 1 : -1;
+    return QRect(geom.x() + s * d.dx, geom.y() + s * d.dy,
+                 geom.width() + s * d.dw, geom.height() + s * d.dh);
+}
+
+qsizetype UndoHistory::estimateBytes(const Entry &entry)
+{
+    // 粗略估算：增量按结构体大小，墓碑按记录大小加状态的紧凑 JSON 长度
+    qsizetype bytes = sizeof(Stored) + entry.deltas.size() * qsizetype(sizeof(GeometryDelta));
+    auto records = [](const QVector<FormRecord> &list) {
+        qsizetype n = 0;
+        for (const FormRecord &rec : list) {
+            n += sizeof(FormRecord);
+            if (!rec.state.isEmpty())
+                n += QJsonDocument(rec.state).toJson(QJsonDocument::Compact).size();
+        }
+        return n;
+    };
+    return bytes + records(entry.removed) + records(entry.created);
+}
+
+void UndoHistory::push(QList<Stored> &stack, Entry entry)
+{
+    Stored s;
+    s.bytes = estimateBytes(entry);
+    s.entry = std::move(entry);
+    m_usage += s.bytes;
+    stack.append(std::move(s));
+}
+
+UndoHistory::Entry UndoHistory::take(QList<Stored> &stack)
+{
+    if (stack.isEmpty())
+        return Entry();
+    Stored s = stack.takeLast();
+    m_usage -= s.bytes;
+    emit changed();
+    return std::move(s.entry);
+}
+
+void UndoHistory::trim()
+{
+    // 先丢最旧的撤销，再丢最远的重做；栈顶（最近一次操作）始终保留
+    while (m_usage > m_limit && m_undo.size() > 1) {
+        m_usage -= m_undo.first().bytes;
+        m_undo.removeFirst();
+    }
+    while (m_usage > m_limit && m_redo.size() > 1) {
+        m_usage -= m_redo.first().bytes;
+        m_redo.removeFirst();
+    }
+}
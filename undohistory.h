@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QRect>
+#include <QVector>
+
+#include "formrecord.h"
+
+// 撤销/重做历史：几何变化只存增量，关闭的组件存墓碑记录；总内存超出上限时丢弃最旧的条目
+class UndoHistory : public QObject
+{
+    Q_OBJECT
+public:
+    // 一个组件的几何增量：to - from，正反两个方向都能由当前几何推出
+    struct GeometryDelta {
+        qint32 id = -1;
+        qint32 dx = 0, dy = 0, dw = 0, dh = 0;
+    };
+
+    // 一次用户操作（一次拖拽手势、一次对齐、一次关闭……）
+    struct Entry {
+        QVector<GeometryDelta> deltas;
+        QVector<FormRecord> removed;    // 操作中被关闭的组件
+        QVector<FormRecord> created;    // 操作中新建的组件
+        bool isEmpty() const { return deltas.isEmpty() && removed.isEmpty() && created.isEmpty(); }
+    };
+
+    static constexpr qsizetype kDefaultMemoryLimit = 4 * 1024 * 1024;
+
+    explicit UndoHistory(QObject *parent = nullptr);
+
+    void setMemoryLimit(qsizetype bytes);
+    qsizetype memoryLimit() const { return m_limit; }
+    qsizetype memoryUsage() const { return m_usage; }
+
+    // 新的用户操作：入撤销栈并清空重做栈
+    void record(Entry entry);
+
+    bool canUndo() const { return !m_undo.isEmpty(); }
+    bool canRedo() const { return !m_redo.isEmpty(); }
+
+    // 取出栈顶交给调用方执行，执行完（可更新墓碑内容）再交回另一侧
+    Entry takeUndo();
+    void finishUndo(Entry entry);
+    Entry takeRedo();
+    void finishRedo(Entry entry);
+
+    void clear();
+
+    // 整份历史（两个栈与内存占用）按值取出与换回；取出后本对象为空
+    struct State;
+    State takeState();
+    void restoreState(State state);
+
+    static GeometryDelta delta(int id, const QRect &from, const QRect &to);
+    static QRect apply(const QRect &geom, const GeometryDelta &d, bool forward);
+
+signals:
+    void changed();
+
+private:
+    struct Stored {
+        Entry entry;
+        qsizetype bytes = 0;
+    };
+
+    static qsizetype estimateBytes(const Entry &entry);
+    void push(QList<Stored> &stack, Entry entry);
+    Entry take(QList<Stored> &stack);
+    void trim();
+
+    QList<Stored> m_undo;
+    QList<Stored> m_redo;
+    qsizetype m_usage = 0;
+    qsizetype m_limit = kDefaultMemoryLimit;
+};
+
+struct UndoHistory::State
+{
+    QList<Stored> undo;
+    QList<Stored> redo;
+    qsizetype usage = 0;
+};